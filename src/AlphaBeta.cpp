@@ -0,0 +1,290 @@
+#include "AlphaBeta.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+// 胜负分和走到它的层数有关，存进置换表时换算成相对当前节点的值，取出时再换回来
+static int scoreToTable(int score, int ply) {
+    if (score > AlphaBeta::kMateScore - 1000) return score + ply;
+    if (score < -AlphaBeta::kMateScore + 1000) return score - ply;
+    return score;
+}
+
+static int scoreFromTable(int score, int ply) {
+    if (score > AlphaBeta::kMateScore - 1000) return score - ply;
+    if (score < -AlphaBeta::kMateScore + 1000) return score + ply;
+    return score;
+}
+
+AlphaBeta::AlphaBeta() : moveLists(kMaxPly), moveOrder(kMaxPly, std::vector<std::pair<int, int>>(kMaxMoves)) {
+    ResetTree();
+}
+
+AlphaBeta::~AlphaBeta() {
+    StopSearch();
+}
+
+void AlphaBeta::AdvanceRoot(const AmazonMove&) {
+    StopSearch();
+}
+
+void AlphaBeta::ResetTree() {
+    StopSearch();
+    std::fill(table.begin(), table.end(), HashEntry{0, PackedMove(), 0, 0, BOUND_NONE});
+    std::memset(killers, 0, sizeof(killers));
+    std::memset(history, 0, sizeof(history));
+    std::memset(arrowHistory, 0, sizeof(arrowHistory));
+}
+
+void AlphaBeta::resizeTable() {
+    if (tableMB == config.hashMB && !table.empty()) return;
+    tableMB = std::max(1, config.hashMB);
+    // 取不超过预算的最大的 2 的幂个桶
+    size_t buckets = 1;
+    while (buckets * 2 * 2 * sizeof(HashEntry) <= static_cast<size_t>(tableMB) * 1024 * 1024) {
+        buckets *= 2;
+    }
+    tableBuckets = buckets;
+    table.assign(buckets * 2, HashEntry{0, PackedMove(), 0, 0, BOUND_NONE});
+}
+
+AlphaBeta::HashEntry* AlphaBeta::probe(uint64_t key) {
+    HashEntry* bucket = &table[(key & (tableBuckets - 1)) * 2];
+    if (bucket[0].key == key && bucket[0].bound != BOUND_NONE) return &bucket[0];
+    if (bucket[1].key == key && bucket[1].bound != BOUND_NONE) return &bucket[1];
+    return nullptr;
+}
+
+void AlphaBeta::store(uint64_t key, int depth, int score, Bound bound, const AmazonMove& best, int ply) {
+    HashEntry* bucket = &table[(key & (tableBuckets - 1)) * 2];
+    // 同一局面直接覆盖；否则深度不小于 0 号项时放进 0 号，不然放进总是替换的 1 号
+    HashEntry* slot;
+    if (bucket[0].key == key || depth >= bucket[0].depth) {
+        slot = &bucket[0];
+    } else {
+        slot = &bucket[1];
+    }
+    slot->key = key;
+    slot->move = PackedMove(best);
+    slot->score = static_cast<int16_t>(scoreToTable(score, ply));
+    slot->depth = static_cast<int8_t>(depth);
+    slot->bound = bound;
+}
+
+int AlphaBeta::evaluate(const AmazonBoard& board, int player) const {
+    if (config.leafEvaluation == EVAL_TERRITORY) {
+        // 领地分以"格"为单位，放大 100 倍成整数
+        double score = TerritoryScore(board, player, player) * 100.0;
+        return static_cast<int>(std::lround(std::max(-20000.0, std::min(20000.0, score))));
+    }
+    return CountMoves(board, player) - CountMoves(board, 3 - player);
+}
+
+bool AlphaBeta::shouldAbort() {
+    if (aborted) return true;
+    nodes++;
+    if (nodeLimit > 0 && nodes >= nodeLimit) {
+        aborted = true;
+    } else if ((nodes & 1023) == 0) {
+        publishedNodes.store(nodes, std::memory_order_relaxed);
+        if (timeUp()) aborted = true;
+    }
+    return aborted;
+}
+
+int AlphaBeta::negamax(AmazonBoard& board, int player, int depth, int alpha, int beta, int ply) {
+    if (shouldAbort()) return 0;
+
+    // 无子可走就输了，越早输分越低
+    if (!HasAnyMove(board, player)) {
+        return -kMateScore + ply;
+    }
+
+    uint64_t key = board.Key(player);
+    AmazonMove ttMove = {0, 0, 0, 0, 0, 0};
+    bool hasTTMove = false;
+    if (HashEntry* e = probe(key)) {
+        AmazonMove m = e->move.unpack();
+        if (IsLegalMove(board, player, m)) {
+            ttMove = m;
+            hasTTMove = true;
+            if (ply > 0 && e->depth >= depth) {
+                int score = scoreFromTable(e->score, ply);
+                if (e->bound == BOUND_EXACT) return score;
+                if (e->bound == BOUND_LOWER && score >= beta) return score;
+                if (e->bound == BOUND_UPPER && score <= alpha) return score;
+            }
+        }
+    }
+
+    // 根节点总是先搜上一层的最佳动作（置换表里那一项可能已经被挤掉了）：
+    // 这一层中途停下时，rootBest 要么还是它，要么是已经证明比它好的动作
+    if (ply == 0) {
+        ttMove = rootBest;
+        hasTTMove = true;
+    }
+
+    if (depth <= 0 || ply >= kMaxPly - 1) {
+        return evaluate(board, player);
+    }
+
+    int originalAlpha = alpha;
+    int bestScore = -kMateScore - 1;
+    AmazonMove bestMove = {0, 0, 0, 0, 0, 0};
+    int searched = 0;
+
+    // 搜一个动作，返回 true 表示发生了 beta 剪枝
+    auto tryMove = [&](const AmazonMove& m) {
+        // 整个搜索只用一块棋盘，走下去之前 MakeMove，回来之后 UnmakeMove
+        board.MakeMove(m, player);
+        int score;
+        if (searched == 0) {
+            score = -negamax(board, 3 - player, depth - 1, -beta, -alpha, ply + 1);
+        } else {
+            // PVS：后面的动作先用零窗口证明它不比当前最好的强，证明失败再用完整窗口重搜
+            score = -negamax(board, 3 - player, depth - 1, -alpha - 1, -alpha, ply + 1);
+            if (score > alpha && score < beta) {
+                score = -negamax(board, 3 - player, depth - 1, -beta, -alpha, ply + 1);
+            }
+        }
+        board.UnmakeMove(m, player);
+        searched++;
+        if (aborted) return true;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = m;
+            if (ply == 0 && score > alpha) {
+                // 根节点上比之前都好的动作是完整搜过的，中途停下也可以用
+                rootBest = m;
+                publishedBest.store(PackedMove(m).bits, std::memory_order_relaxed);
+            }
+        }
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) {
+            // 引起剪枝的动作记进杀手表和历史表，别的节点优先尝试
+            if (!(m == killers[ply][0])) {
+                killers[ply][1] = killers[ply][0];
+                killers[ply][0] = m;
+            }
+            int from = SquareOf(m.qx1, m.qy1), to = SquareOf(m.qx2, m.qy2), arrow = SquareOf(m.ax, m.ay);
+            history[player][from][to] += depth * depth;
+            arrowHistory[player][to][arrow] += depth * depth;
+            return true;
+        }
+        return false;
+    };
+
+    // 置换表里的动作先搜，经常一步就剪掉，连走法都不用生成
+    if (hasTTMove && tryMove(ttMove)) {
+        if (aborted) return 0;
+        store(key, depth, bestScore, BOUND_LOWER, bestMove, ply);
+        return bestScore;
+    }
+
+    MoveList& moves = moveLists[ply];
+    std::vector<std::pair<int, int>>& order = moveOrder[ply]; // (排序分, 动作下标)
+    GenerateMoves(board, player, moves);
+    int n = moves.size();
+    for (int i = 0; i < n; i++) {
+        const AmazonMove& m = moves[i];
+        int from = SquareOf(m.qx1, m.qy1), to = SquareOf(m.qx2, m.qy2), arrow = SquareOf(m.ax, m.ay);
+        int score;
+        if (m == killers[ply][0]) {
+            score = std::numeric_limits<int>::max() - 1;
+        } else if (m == killers[ply][1]) {
+            score = std::numeric_limits<int>::max() - 2;
+        } else {
+            score = history[player][from][to] + arrowHistory[player][to][arrow];
+        }
+        order[i] = std::make_pair(score, i);
+    }
+
+    // 剪枝通常发生在前几个动作：先逐个挑出分数最高的，挑了几个还没剪枝再把剩下的整体排序
+    const int kSelectFirst = 4;
+    for (int i = 0; i < n; i++) {
+        if (i < kSelectFirst) {
+            std::swap(order[i], *std::max_element(order.begin() + i, order.begin() + n));
+        } else if (i == kSelectFirst) {
+            std::sort(order.begin() + i, order.begin() + n, std::greater<std::pair<int, int>>());
+        }
+        const AmazonMove& m = moves[order[i].second];
+        if (hasTTMove && m == ttMove) continue;
+        if (tryMove(m)) break;
+    }
+    if (aborted) return 0;
+
+    Bound bound = bestScore >= beta ? BOUND_LOWER : (bestScore > originalAlpha ? BOUND_EXACT : BOUND_UPPER);
+    store(key, depth, bestScore, bound, bestMove, ply);
+    return bestScore;
+}
+
+bool AlphaBeta::prepareRoot(const AmazonBoard& currentBoard, int aiPlayer) {
+    rootFallback = AmazonMove{0, 0, 0, 0, 0, 0};
+    if (!MoveAtIndex(currentBoard, aiPlayer, 0, rootFallback)) {
+        return false;
+    }
+    resizeTable();
+    rootBest = rootFallback;
+    publishedBest.store(PackedMove(rootFallback).bits, std::memory_order_relaxed);
+    return true;
+}
+
+AmazonMove AlphaBeta::currentBest() const {
+    return PackedMove(publishedBest.load(std::memory_order_relaxed)).unpack();
+}
+
+void AlphaBeta::collectStats(SearchStats& stats, int topMoves) const {
+    stats.iterations = static_cast<uint64_t>(publishedNodes.load(std::memory_order_relaxed));
+    stats.maxDepth = publishedDepth.load(std::memory_order_relaxed);
+    stats.score = publishedScore.load(std::memory_order_relaxed);
+    stats.solved = solvedByEndgame.load(std::memory_order_relaxed);
+    // 没有根孩子的访问统计，只列当前最佳动作
+    if (topMoves > 0) stats.topMoves.push_back({currentBest(), 0, 0.5});
+}
+
+AmazonMove AlphaBeta::search(const AmazonBoard& currentBoard, int aiPlayer, const SearchLimits& limits) {
+    publishedNodes = 0;
+    publishedDepth = 0;
+    publishedScore = 0;
+    solvedByEndgame = false;
+    // 双方已经分开：数步数就能下出完美的一步
+    if (config.endgameSolver) {
+        endgame.setNodeBudget(config.endgameNodeBudget);
+        endgame.setMemoLimit(EndgameSolver::MemoEntriesForMB(config.endgameMemoryMB));
+        AmazonMove m;
+        if (endgame.bestMove(currentBoard, aiPlayer, m)) {
+            publishedBest.store(PackedMove(m).bits, std::memory_order_relaxed);
+            solvedByEndgame = true;
+            return m;
+        }
+    }
+
+    nodes = 0;
+    nodeLimit = limits.iterations;
+    aborted = false;
+    completedDepth = 0;
+    // 新的一次搜索，历史分减半，旧局面里的经验慢慢淡出
+    for (auto& byPlayer : history) for (auto& row : byPlayer) for (int& h : row) h /= 2;
+    for (auto& byPlayer : arrowHistory) for (auto& row : byPlayer) for (int& h : row) h /= 2;
+
+    AmazonMove best = rootFallback;
+    int maxDepth = config.maxDepth > 0 ? std::min(config.maxDepth, kMaxPly - 1) : kMaxPly - 1;
+    AmazonBoard board = currentBoard;
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        int score = negamax(board, aiPlayer, depth, -kMateScore - 1, kMateScore + 1, 0);
+        // 没搜完的一层里，只有已经证明比上一层结果好的根动作才可信，rootBest 已经处理了这一点
+        best = rootBest;
+        if (aborted) break;
+        completedDepth = depth;
+        lastScore = score;
+        publishedDepth.store(depth, std::memory_order_relaxed);
+        publishedScore.store(score, std::memory_order_relaxed);
+        // 已经算出胜负就不用再加深了
+        if (std::abs(score) > kMateScore - 1000) break;
+    }
+    publishedNodes.store(nodes, std::memory_order_relaxed);
+    return best;
+}
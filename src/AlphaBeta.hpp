@@ -0,0 +1,111 @@
+#ifndef ALPHA_BETA_HPP
+#define ALPHA_BETA_HPP
+
+#include "Board.hpp"
+#include "Endgame.hpp"
+#include "Evaluation.hpp"
+#include "MoveGen.hpp"
+#include "SearchEngine.hpp"
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// alpha-beta 引擎的参数
+struct AlphaBetaConfig {
+    // 叶子局面的评估方式
+    LeafEvaluation leafEvaluation = EVAL_TERRITORY;
+    // 迭代加深最多到几层，0 表示只受预算限制
+    int maxDepth = 0;
+    // 置换表大小（MB）
+    int hashMB = 64;
+    // 双方分开后改用精确的残局求解
+    bool endgameSolver = true;
+    int endgameNodeBudget = 2000000;
+    // 残局求解器记忆表最多占多少内存（MB），0 表示不限，不算在 hashMB 里
+    int endgameMemoryMB = 192;
+};
+
+// 迭代加深的 alpha-beta（PVS 变体）。走法排序依次是：置换表里的最佳动作、两个杀手动作、历史表得分。
+// 单线程搜索；置换表、杀手表和历史表跨回合保留，局面往下走时之前的结果依然有用
+class AlphaBeta : public SearchEngine {
+public:
+    AlphaBetaConfig config;
+
+    AlphaBeta();
+    ~AlphaBeta();
+
+    // 置换表按局面存，和走到哪一步无关，这里只需要停掉后台思考
+    void AdvanceRoot(const AmazonMove& m) override;
+    // 清空置换表、杀手表和历史表
+    void ResetTree() override;
+    const char* Name() const override { return "Alpha-Beta"; }
+
+    // 最近一次搜索完整搜完的深度、那一层的根节点分数（轮到走的一方视角）和访问的节点数，对比两个引擎时用
+    int CompletedDepth() const { return completedDepth; }
+    int LastScore() const { return lastScore; }
+    long NodesSearched() const { return nodes; }
+
+    // 分数范围：一方无子可走时是 -kMateScore + 已走的层数，评估分远小于它
+    static const int kMateScore = 30000;
+    static const int kMaxPly = 64;
+
+protected:
+    bool prepareRoot(const AmazonBoard& currentBoard, int aiPlayer) override;
+    AmazonMove search(const AmazonBoard& currentBoard, int aiPlayer, const SearchLimits& limits) override;
+    AmazonMove currentBest() const override;
+    void collectStats(SearchStats& stats, int topMoves) const override;
+
+private:
+    enum Bound : uint8_t { BOUND_NONE = 0, BOUND_UPPER = 1, BOUND_LOWER = 2, BOUND_EXACT = 3 };
+
+    // 置换表的一项正好 16 字节；动作压成 18 位（三个格子下标）
+    struct HashEntry {
+        uint64_t key;
+        PackedMove move;
+        int16_t score;
+        int8_t depth;
+        uint8_t bound;
+    };
+
+    // 每个桶两项：0 号按深度优先替换，1 号总是替换
+    std::vector<HashEntry> table;
+    size_t tableBuckets = 0;
+    int tableMB = 0;
+
+    AmazonMove killers[kMaxPly][2];
+    int history[3][64][64];       // [玩家][起点][落点]，引起剪枝的女王移动
+    int arrowHistory[3][64][64];  // [玩家][落点][箭]，引起剪枝的射箭
+
+    // 每层一个走法缓冲区和排序用的 (分数, 下标)，递归时不做堆分配
+    std::vector<MoveList> moveLists;
+    std::vector<std::vector<std::pair<int, int>>> moveOrder;
+
+    EndgameSolver endgame{0};
+
+    long nodes = 0;
+    long nodeLimit = 0;
+    bool aborted = false;
+    int completedDepth = 0;
+    int lastScore = 0;
+    AmazonMove rootBest = {0, 0, 0, 0, 0, 0};
+    std::atomic<uint32_t> publishedBest{0}; // 给其他线程看的当前最佳动作（PackedMove::bits）
+    // 给其他线程看的统计：节点数每 1024 个节点更新一次，深度和分数每搜完一层更新
+    std::atomic<long> publishedNodes{0};
+    std::atomic<int> publishedDepth{0};
+    std::atomic<int> publishedScore{0};
+    std::atomic<bool> solvedByEndgame{false};
+
+    // board 在递归中被 MakeMove / UnmakeMove 改动，返回时恢复原样
+    int negamax(AmazonBoard& board, int player, int depth, int alpha, int beta, int ply);
+    int evaluate(const AmazonBoard& board, int player) const;
+
+    HashEntry* probe(uint64_t key);
+    void store(uint64_t key, int depth, int score, Bound bound, const AmazonMove& best, int ply);
+    void resizeTable();
+
+    // 刚走到的新节点检查一下是不是该停了（每 1024 个节点查一次时钟）
+    bool shouldAbort();
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef BITBOARD_HPP
+#define BITBOARD_HPP
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// 8x8 棋盘正好放进一个 uint64_t：第 y 行第 x 列对应第 (y * 8 + x) 位
+typedef uint64_t Bitboard;
+
+inline int SquareOf(int x, int y) { return y * 8 + x; }
+inline int SquareX(int sq) { return sq & 7; }
+inline int SquareY(int sq) { return sq >> 3; }
+inline Bitboard SquareBit(int sq) { return 1ULL << sq; }
+
+inline int PopCount(Bitboard b) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<int>(__popcnt64(b));
+#else
+    return __builtin_popcountll(b);
+#endif
+}
+
+// 最低位的 1 的下标，b 不能为 0
+inline int LowestBit(Bitboard b) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanForward64(&idx, b);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctzll(b);
+#endif
+}
+
+// 最高位的 1 的下标，b 不能为 0
+inline int HighestBit(Bitboard b) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanReverse64(&idx, b);
+    return static_cast<int>(idx);
+#else
+    return 63 - __builtin_clzll(b);
+#endif
+}
+
+// 取出并清掉最低位，用来遍历一个集合里的所有格子
+inline int PopLowestBit(Bitboard& b) {
+    int sq = LowestBit(b);
+    b &= b - 1;
+    return sq;
+}
+
+// 集合 b 中第 n 个（从 0 开始，按下标从小到大）格子，n 必须小于 PopCount(b)
+inline int NthBit(Bitboard b, int n) {
+    for (int i = 0; i < n; i++) {
+        b &= b - 1;
+    }
+    return LowestBit(b);
+}
+
+// 列掩码：去掉第 0 列 / 第 7 列，防止左右平移时从棋盘一边绕到另一边
+const Bitboard kNotFileA = 0xfefefefefefefefeULL;
+const Bitboard kNotFileH = 0x7f7f7f7f7f7f7f7fULL;
+
+// 集合 b 中所有格子的八邻域（国王一步能到的格子）的并集
+inline Bitboard KingAttacks(Bitboard b) {
+    Bitboard sideways = ((b << 1) & kNotFileA) | ((b >> 1) & kNotFileH);
+    Bitboard row = b | sideways;
+    return sideways | (row << 8) | (row >> 8);
+}
+
+// 八个方向。前四个方向格子下标递增（遇到的第一个障碍是最低位），后四个递减（第一个障碍是最高位）
+enum Direction { DIR_E = 0, DIR_S, DIR_SE, DIR_SW, DIR_W, DIR_N, DIR_NW, DIR_NE };
+
+const int kDirDx[8] = {1, 0, 1, -1, -1, 0, -1, 1};
+const int kDirDy[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+// 预计算的射线表：rays[d][sq] 是从 sq 出发沿方向 d 直到棋盘边缘的所有格子（不含 sq 本身）
+struct RayTable {
+    Bitboard rays[8][64];
+
+    constexpr RayTable() : rays() {
+        for (int d = 0; d < 8; d++) {
+            for (int sq = 0; sq < 64; sq++) {
+                Bitboard ray = 0;
+                int x = (sq & 7) + kDirDx[d];
+                int y = (sq >> 3) + kDirDy[d];
+                while (x >= 0 && x < 8 && y >= 0 && y < 8) {
+                    ray |= 1ULL << (y * 8 + x);
+                    x += kDirDx[d];
+                    y += kDirDy[d];
+                }
+                rays[d][sq] = ray;
+            }
+        }
+    }
+};
+
+inline constexpr RayTable kRayTable{};
+
+// 女王（或箭）从 sq 出发、在 occupied 阻挡下能到达的所有空格
+inline Bitboard QueenAttacks(int sq, Bitboard occupied) {
+    Bitboard attacks = 0;
+    for (int d = 0; d < 4; d++) {
+        Bitboard ray = kRayTable.rays[d][sq];
+        Bitboard blockers = ray & occupied;
+        if (blockers) {
+            int b = LowestBit(blockers);
+            ray &= ~(kRayTable.rays[d][b] | SquareBit(b));
+        }
+        attacks |= ray;
+    }
+    for (int d = 4; d < 8; d++) {
+        Bitboard ray = kRayTable.rays[d][sq];
+        Bitboard blockers = ray & occupied;
+        if (blockers) {
+            int b = HighestBit(blockers);
+            ray &= ~(kRayTable.rays[d][b] | SquareBit(b));
+        }
+        attacks |= ray;
+    }
+    return attacks;
+}
+
+// 整个集合沿某个方向平移 steps 格（每格下标加 Shift），Mask 去掉从棋盘一边绕到另一边的位
+template <int Shift, Bitboard Mask>
+inline Bitboard ShiftBy(Bitboard b, int steps = 1) {
+    return Shift > 0 ? (b << (Shift * steps)) & Mask : (b >> (-Shift * steps)) & Mask;
+}
+
+// Kogge-Stone 填充：sources 里所有格子同时沿一个方向滑过 empty，返回 sources 加上滑过的格子。
+// 三轮移位就能走完任意长的射线，和起点个数无关
+template <int Shift, Bitboard Mask>
+inline Bitboard SlideFill(Bitboard sources, Bitboard empty) {
+    Bitboard pro = empty & Mask;
+    sources |= pro & ShiftBy<Shift, ~0ULL>(sources, 1);
+    pro &= ShiftBy<Shift, ~0ULL>(pro, 1);
+    sources |= pro & ShiftBy<Shift, ~0ULL>(sources, 2);
+    pro &= ShiftBy<Shift, ~0ULL>(pro, 2);
+    sources |= pro & ShiftBy<Shift, ~0ULL>(sources, 4);
+    return sources;
+}
+
+template <int Shift, Bitboard Mask>
+inline Bitboard SlideAttacks(Bitboard sources, Bitboard empty) {
+    return ShiftBy<Shift, Mask>(SlideFill<Shift, Mask>(sources, empty)) & empty;
+}
+
+// 集合 sources 中所有格子按女王走法一步能到达的空格的并集（多源版本的 QueenAttacks）
+inline Bitboard SlidingAttacks(Bitboard sources, Bitboard empty) {
+    return SlideAttacks<1, kNotFileA>(sources, empty) |   // 东
+           SlideAttacks<-1, kNotFileH>(sources, empty) |  // 西
+           SlideAttacks<8, ~0ULL>(sources, empty) |       // 南
+           SlideAttacks<-8, ~0ULL>(sources, empty) |      // 北
+           SlideAttacks<9, kNotFileA>(sources, empty) |   // 东南
+           SlideAttacks<7, kNotFileH>(sources, empty) |   // 西南
+           SlideAttacks<-7, kNotFileA>(sources, empty) |  // 东北
+           SlideAttacks<-9, kNotFileH>(sources, empty);   // 西北
+}
+
+#endif
@@ -1,48 +1,49 @@
 #include "Board.hpp"
-#include <cmath>
 
 
 AmazonBoard::AmazonBoard() {
     // 1. 先清空棋盘
-    for (int y = 0; y < 8; y++) {
-        for (int x = 0; x < 8; x++) {
-            grid[y][x] = EMPTY;
-        }
-    }
+    white = black = arrows = occupied = 0;
+    hash = 0;
 
     // 2. 设置亚马逊棋 8x8 初始位置 (经典布局)
     // 黑方 (2)
-    grid[0][2] = BLACK_QUEEN; grid[0][5] = BLACK_QUEEN;
-    grid[2][0] = BLACK_QUEEN; grid[2][7] = BLACK_QUEEN;
+    SetPiece(2, 0, BLACK_QUEEN); SetPiece(5, 0, BLACK_QUEEN);
+    SetPiece(0, 2, BLACK_QUEEN); SetPiece(7, 2, BLACK_QUEEN);
     // 白方 (1)
-    grid[5][0] = WHITE_QUEEN; grid[5][7] = WHITE_QUEEN;
-    grid[7][2] = WHITE_QUEEN; grid[7][5] = WHITE_QUEEN;
+    SetPiece(0, 5, WHITE_QUEEN); SetPiece(7, 5, WHITE_QUEEN);
+    SetPiece(2, 7, WHITE_QUEEN); SetPiece(5, 7, WHITE_QUEEN);
 }
 
 bool AmazonBoard::IsPathClear(int x1, int y1, int x2, int y2) const {
+    if (x1 < 0 || x1 >= 8 || y1 < 0 || y1 >= 8) return false;
     if (x2 < 0 || x2 >= 8 || y2 < 0 || y2 >= 8) return false;
-    if (grid[y2][x2] != EMPTY) return false;
-
-    int dx = (x2 > x1) ? 1 : (x2 < x1 ? -1 : 0);
-    int dy = (y2 > y1) ? 1 : (y2 < y1 ? -1 : 0);
-
-    if (dx == 0 && dy == 0) return false;
-    if (dx != 0 && dy != 0 && std::abs(x1 - x2) != std::abs(y1 - y2)) return false;
-
-    int curX = x1 + dx;
-    int curY = y1 + dy;
-    while (curX != x2 || curY != y2) {
-        if (grid[curY][curX] != EMPTY) return false;
-        curX += dx;
-        curY += dy;
-    }
-    return true;
+
+    // 射线表已经处理了方向、对齐和中途阻挡，目标格必须为空也包含在内
+    return (QueenAttacks(SquareOf(x1, y1), occupied) & SquareBit(SquareOf(x2, y2))) != 0;
 }
 
 int AmazonBoard::GetPiece(int x, int y) const {
-    return grid[y][x];
+    Bitboard bit = SquareBit(SquareOf(x, y));
+    if (!(occupied & bit)) return EMPTY;
+    if (white & bit) return WHITE_QUEEN;
+    if (black & bit) return BLACK_QUEEN;
+    return ARROW;
 }
 
 void AmazonBoard::SetPiece(int x, int y, int type) {
-    grid[y][x] = type;
-}
\ No newline at end of file
+    int sq = SquareOf(x, y);
+    Bitboard bit = SquareBit(sq);
+    hash ^= kZobrist.pieces[GetPiece(x, y)][sq] ^ kZobrist.pieces[type & 3][sq];
+
+    white &= ~bit;
+    black &= ~bit;
+    arrows &= ~bit;
+    occupied &= ~bit;
+
+    if (type == WHITE_QUEEN) white |= bit;
+    else if (type == BLACK_QUEEN) black |= bit;
+    else if (type == ARROW) arrows |= bit;
+    else return;
+    occupied |= bit;
+}
@@ -1,15 +1,60 @@
 #ifndef BOARD_HPP
 #define BOARD_HPP
 
-#include <cmath>
-#include <vector>
+#include "Bitboard.hpp"
+#include "Zobrist.hpp"
 
 // 定义格子状态
 enum TileState { EMPTY = 0, WHITE_QUEEN = 1, BLACK_QUEEN = 2, ARROW = 3 };
 
+// 定义一个完整的亚马逊棋动作。坐标都在 0..7，按字节存，整个动作 6 字节，走法列表更紧凑；
+// 外部协议里"无子可走"用全 -1 表示
+struct AmazonMove {
+    int8_t qx1, qy1, qx2, qy2; // 移动女王
+    int8_t ax, ay;             // 射箭
+
+    AmazonMove() = default;
+    AmazonMove(int qx1_, int qy1_, int qx2_, int qy2_, int ax_, int ay_)
+        : qx1(static_cast<int8_t>(qx1_)), qy1(static_cast<int8_t>(qy1_)), qx2(static_cast<int8_t>(qx2_)),
+          qy2(static_cast<int8_t>(qy2_)), ax(static_cast<int8_t>(ax_)), ay(static_cast<int8_t>(ay_)) {}
+
+    bool operator==(const AmazonMove& o) const {
+        return qx1 == o.qx1 && qy1 == o.qy1 && qx2 == o.qx2 && qy2 == o.qy2 && ax == o.ax && ay == o.ay;
+    }
+    bool operator!=(const AmazonMove& o) const { return !(*this == o); }
+};
+
+// 压缩成 18 位的动作：起点、落点、箭的格子下标各占 6 位。
+// 0 表示"没有动作"（起点和落点不可能相同）。搜索树节点、置换表、开局库、存档和对局库里都存这个
+struct PackedMove {
+    uint32_t bits = 0;
+
+    PackedMove() = default;
+    explicit PackedMove(uint32_t raw) : bits(raw) {}
+    explicit PackedMove(const AmazonMove& m)
+        : bits(static_cast<uint32_t>(SquareOf(m.qx1, m.qy1) | (SquareOf(m.qx2, m.qy2) << 6) | (SquareOf(m.ax, m.ay) << 12))) {}
+
+    int from() const { return bits & 63; }
+    int to() const { return (bits >> 6) & 63; }
+    int arrow() const { return (bits >> 12) & 63; }
+    bool isNull() const { return bits == 0; }
+
+    AmazonMove unpack() const {
+        return AmazonMove(SquareX(from()), SquareY(from()), SquareX(to()), SquareY(to()), SquareX(arrow()), SquareY(arrow()));
+    }
+
+    bool operator==(const PackedMove& o) const { return bits == o.bits; }
+    bool operator!=(const PackedMove& o) const { return bits != o.bits; }
+};
+
 class AmazonBoard {
 public:
-    int grid[8][8]; // 棋盘数据
+    // 棋盘数据：每种棋子一张位棋盘，occupied 是三者的并集，方便走法生成直接使用
+    Bitboard white;    // 白方女王 (1)
+    Bitboard black;    // 黑方女王 (2)
+    Bitboard arrows;   // 箭/障碍 (3)
+    Bitboard occupied; // 所有非空格子
+    uint64_t hash;     // 局面的 Zobrist 哈希（不含轮到谁走），SetPiece 时增量维护
 
     AmazonBoard();  // 构造函数：初始化棋盘
 
@@ -19,8 +64,49 @@ public:
     // 获取某个位置的状态
     int GetPiece(int x, int y) const;
     
-    // 修改某个位置的状态
+    // 修改某个位置的状态（摆棋、读档用；走子用 MakeMove）
     void SetPiece(int x, int y, int type);
+
+    // player 走出合法动作：女王从 from 到 to 再射箭到 arrow（都是格子下标）。
+    // 位棋盘、occupied 和哈希都用异或增量更新，不逐格判断原来是什么
+    void MakeMove(int from, int to, int arrow, int player) {
+        Bitboard move = SquareBit(from) | SquareBit(to);
+        (player == WHITE_QUEEN ? white : black) ^= move;
+        occupied ^= move;
+        // 箭可以射回女王刚离开的格子，所以先挪女王再放箭
+        arrows |= SquareBit(arrow);
+        occupied |= SquareBit(arrow);
+        hash ^= ZobristMoveDelta(from, to, arrow, player);
+    }
+    void MakeMove(const AmazonMove& m, int player) {
+        MakeMove(SquareOf(m.qx1, m.qy1), SquareOf(m.qx2, m.qy2), SquareOf(m.ax, m.ay), player);
+    }
+    void MakeMove(PackedMove m, int player) { MakeMove(m.from(), m.to(), m.arrow(), player); }
+
+    // 撤销 player 刚走的动作，棋盘回到 MakeMove 之前的样子
+    void UnmakeMove(int from, int to, int arrow, int player) {
+        Bitboard move = SquareBit(from) | SquareBit(to);
+        arrows &= ~SquareBit(arrow);
+        occupied &= ~SquareBit(arrow);
+        (player == WHITE_QUEEN ? white : black) ^= move;
+        occupied ^= move;
+        hash ^= ZobristMoveDelta(from, to, arrow, player);
+    }
+    void UnmakeMove(const AmazonMove& m, int player) {
+        UnmakeMove(SquareOf(m.qx1, m.qy1), SquareOf(m.qx2, m.qy2), SquareOf(m.ax, m.ay), player);
+    }
+    void UnmakeMove(PackedMove m, int player) { UnmakeMove(m.from(), m.to(), m.arrow(), player); }
+
+    bool operator==(const AmazonBoard& other) const {
+        return white == other.white && black == other.black && arrows == other.arrows;
+    }
+    bool operator!=(const AmazonBoard& other) const { return !(*this == other); }
+
+    // 置换表用的键：棋盘哈希再加上轮到谁走
+    uint64_t Key(int playerToMove) const { return hash ^ kZobrist.side[playerToMove]; }
+
+    // 某一方所有女王所在的格子
+    Bitboard Queens(int player) const { return player == WHITE_QUEEN ? white : black; }
 };
 
-#endif
\ No newline at end of file
+#endif
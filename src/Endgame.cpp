@@ -0,0 +1,142 @@
+#include "Endgame.hpp"
+
+Bitboard FloodRegion(Bitboard seeds, Bitboard passable) {
+    Bitboard region = seeds;
+    while (true) {
+        Bitboard grown = region | (KingAttacks(region) & passable);
+        if (grown == region) return region;
+        region = grown;
+    }
+}
+
+bool IsSeparated(const AmazonBoard& board) {
+    // 白方女王能连到的地方（箭以外都能通过）碰不到任何黑方女王
+    Bitboard reach = FloodRegion(board.white, ~board.arrows);
+    return (reach & board.black) == 0;
+}
+
+// 逐个把 queens 在 empty 里的动作交给 visit(from, to, arrow, 动作后的女王, 动作后的空格)，visit 返回 false 时停止
+template <typename Visitor>
+static void forEachRegionMove(Bitboard queens, Bitboard empty, Visitor&& visit) {
+    Bitboard occupied = ~empty;
+    for (Bitboard qs = queens; qs;) {
+        int from = PopLowestBit(qs);
+        Bitboard occupiedAfterLeave = occupied & ~SquareBit(from);
+        for (Bitboard targets = QueenAttacks(from, occupied); targets;) {
+            int to = PopLowestBit(targets);
+            Bitboard childQueens = queens ^ SquareBit(from) ^ SquareBit(to);
+            Bitboard emptyAfterMove = (empty | SquareBit(from)) & ~SquareBit(to);
+            for (Bitboard arrows = QueenAttacks(to, occupiedAfterLeave); arrows;) {
+                int arrow = PopLowestBit(arrows);
+                if (!visit(from, to, arrow, childQueens, emptyAfterMove & ~SquareBit(arrow))) return;
+            }
+        }
+    }
+}
+
+int EndgameSolver::search(Bitboard queens, Bitboard empty, bool& exact) {
+    // 女王连不到的空格永远用不上，去掉之后记忆表的键也更统一
+    empty &= FloodRegion(queens, empty);
+    int upper = PopCount(empty);
+    if (upper == 0) return 0;
+
+    Key key{queens, empty};
+    auto it = memo.find(key);
+    if (it != memo.end()) return it->second;
+    if (++nodes > nodeBudget) {
+        exact = false;
+        return 0;
+    }
+
+    // 每走一步正好多一支箭，最多走 upper 步；找到这么长的走法就不用再搜了
+    int best = 0;
+    bool allExact = true;
+    forEachRegionMove(queens, empty, [&](int, int, int, Bitboard childQueens, Bitboard childEmpty) {
+        bool childExact = true;
+        int value = 1 + search(childQueens, childEmpty, childExact);
+        allExact = allExact && childExact;
+        if (value > best) best = value;
+        return best < upper && nodes <= nodeBudget;
+    });
+
+    if (best == upper || (allExact && nodes <= nodeBudget)) {
+        if (memoLimit != 0 && memo.size() >= memoLimit) memo.clear();
+        memo[key] = static_cast<uint8_t>(best);
+    } else {
+        exact = false;
+    }
+    return best;
+}
+
+MoveCountBound EndgameSolver::bound(Bitboard queens, Bitboard empty) {
+    bool exact = true;
+    MoveCountBound b;
+    b.lower = search(queens, empty, exact);
+    b.upper = exact ? b.lower : PopCount(empty & FloodRegion(queens, empty));
+    return b;
+}
+
+MoveCountBound EndgameSolver::countMoves(Bitboard queens, Bitboard empty) {
+    nodes = 0;
+    return bound(queens, empty);
+}
+
+MoveCountBound EndgameSolver::sideBound(const AmazonBoard& board, int player) {
+    Bitboard own = board.Queens(player);
+    Bitboard empty = ~board.occupied;
+    MoveCountBound total;
+    for (Bitboard remaining = own; remaining;) {
+        Bitboard region = FloodRegion(SquareBit(LowestBit(remaining)), empty | own);
+        remaining &= ~region;
+        MoveCountBound b = bound(own & region, empty & region);
+        total.lower += b.lower;
+        total.upper += b.upper;
+    }
+    return total;
+}
+
+bool EndgameSolver::analyze(const AmazonBoard& board, int playerToMove, EndgameOutcome& out) {
+    if (!IsSeparated(board)) return false;
+    nodes = 0;
+    out.mine = sideBound(board, playerToMove);
+    out.theirs = sideBound(board, 3 - playerToMove);
+    if (out.mine.lower > out.theirs.upper) {
+        out.result = 1;
+    } else if (out.mine.upper <= out.theirs.lower) {
+        out.result = -1;
+    } else {
+        out.result = 0;
+    }
+    return true;
+}
+
+bool EndgameSolver::bestMove(const AmazonBoard& board, int player, AmazonMove& out) {
+    if (!IsSeparated(board)) return false;
+    nodes = 0;
+    Bitboard own = board.Queens(player);
+    Bitboard empty = ~board.occupied;
+    for (Bitboard remaining = own; remaining;) {
+        Bitboard region = FloodRegion(SquareBit(LowestBit(remaining)), empty | own);
+        remaining &= ~region;
+        Bitboard queens = own & region;
+        Bitboard regionEmpty = empty & region;
+
+        // 各区域互不影响，在任何一个算精确了的区域里走出最长的那一步都是最优的
+        bool exact = true;
+        int value = search(queens, regionEmpty, exact);
+        if (!exact || value == 0) continue;
+
+        bool found = false;
+        forEachRegionMove(queens, regionEmpty, [&](int from, int to, int arrow, Bitboard childQueens, Bitboard childEmpty) {
+            bool childExact = true;
+            // value 是最大值，子局面的下界加 1 达到它就说明这一步不损失步数
+            if (1 + search(childQueens, childEmpty, childExact) == value) {
+                out = AmazonMove{SquareX(from), SquareY(from), SquareX(to), SquareY(to), SquareX(arrow), SquareY(arrow)};
+                found = true;
+            }
+            return !found;
+        });
+        if (found) return true;
+    }
+    return false;
+}
@@ -0,0 +1,85 @@
+#ifndef ENDGAME_HPP
+#define ENDGAME_HPP
+
+#include "Board.hpp"
+#include "MoveGen.hpp"
+#include <cstdint>
+#include <unordered_map>
+
+// seeds 在 passable 里按国王走法连通的所有格子（含 seeds 本身）
+Bitboard FloodRegion(Bitboard seeds, Bitboard passable);
+
+// 箭把棋盘分成了互不相通的区域，而且没有哪个区域里同时有双方的女王。
+// 这时双方互不干扰，胜负只取决于各自在自己的区域里还能走多少步
+bool IsSeparated(const AmazonBoard& board);
+
+// 一方最多还能走的步数的上下界，lower == upper 时是精确值
+struct MoveCountBound {
+    int lower = 0;
+    int upper = 0;
+    bool exact() const { return lower == upper; }
+};
+
+// 分离局面的结论，从轮到走的一方看
+struct EndgameOutcome {
+    MoveCountBound mine;    // 轮到走的一方
+    MoveCountBound theirs;  // 对方
+    // 1：轮到走的一方必胜；-1：必败；0：界不够紧，还判断不了。
+    // 轮到走的一方步数 a、对方 b 时，a > b 才赢（先走的一方先用完就输）
+    int result = 0;
+};
+
+// 分离局面的精确求解：对每个只有一方女王的区域，搜索这一方在区域里最多能走几步（"填格子"问题），
+// 结果按 (女王, 空格) 掩码记忆化。每次调用最多访问 nodeBudget 个局面，超出预算时只给出上下界
+class EndgameSolver {
+public:
+    explicit EndgameSolver(long nodeBudget) : nodeBudget(nodeBudget) {}
+
+    // queens 只能在 empty 里活动时最多能走几步（empty 之外都当作占用）
+    MoveCountBound countMoves(Bitboard queens, Bitboard empty);
+
+    // 分离局面里双方的步数和胜负；局面没有分离时返回 false
+    bool analyze(const AmazonBoard& board, int playerToMove, EndgameOutcome& out);
+
+    // 分离局面里为 player 找一个不损失步数的动作：动作后 player 的总步数恰好少 1，这就是最优着法。
+    // 局面没有分离，或者预算内没能把某个区域算精确时返回 false
+    bool bestMove(const AmazonBoard& board, int player, AmazonMove& out);
+
+    void setNodeBudget(long budget) { nodeBudget = budget; }
+
+    // 记忆表一项连同哈希表的节点和桶实际占的字节数（libstdc++ 上实测），按内存预算换算项数时用
+    static const size_t kMemoEntryBytes = 48;
+    static size_t MemoEntriesForMB(int megabytes) {
+        return megabytes > 0 ? (static_cast<size_t>(megabytes) << 20) / kMemoEntryBytes : 0;
+    }
+    // 记忆表最多存多少项（0 表示不限），已经超出的马上清掉，搜索中途存满了也整个清掉重来
+    void setMemoLimit(size_t maxEntries) {
+        memoLimit = maxEntries;
+        if (memoLimit != 0 && memo.size() > memoLimit) memo.clear();
+    }
+    size_t memoSize() const { return memo.size(); }
+    size_t memoryBytes() const { return memo.size() * kMemoEntryBytes; }
+
+private:
+    struct Key {
+        Bitboard queens, empty;
+        bool operator==(const Key& o) const { return queens == o.queens && empty == o.empty; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const { return static_cast<size_t>(k.queens * 0x9E3779B97F4A7C15ULL ^ k.empty); }
+    };
+
+    long nodeBudget;
+    long nodes = 0;
+    size_t memoLimit = 0;
+    std::unordered_map<Key, uint8_t, KeyHash> memo; // 只存精确值
+
+    // 返回找到的最长步数，exact 在预算耗尽时被清成 false
+    int search(Bitboard queens, Bitboard empty, bool& exact);
+    // search 的结果加上上界（女王能连到的空格数）
+    MoveCountBound bound(Bitboard queens, Bitboard empty);
+    // player 在所有区域里的步数之和
+    MoveCountBound sideBound(const AmazonBoard& board, int player);
+};
+
+#endif
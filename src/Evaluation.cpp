@@ -0,0 +1,121 @@
+#include "Evaluation.hpp"
+#include "MoveGen.hpp"
+#include <algorithm>
+#include <cmath>
+
+// 从 sources 出发一层层往外扩，step(frontier) 给出 frontier 一步能到的空格，每层只记下到达集合
+template <typename Step>
+static void floodLayers(Bitboard sources, Bitboard empty, DistanceLayers& out, Step step) {
+    Bitboard reached = 0;
+    Bitboard frontier = sources;
+    out.count = 0;
+    while (true) {
+        frontier = step(frontier) & empty & ~reached;
+        if (!frontier) break;
+        reached |= frontier;
+        out.reached[out.count++] = reached;
+    }
+}
+
+void QueenLayers(Bitboard sources, Bitboard empty, DistanceLayers& out) {
+    floodLayers(sources, empty, out, [empty](Bitboard frontier) { return SlidingAttacks(frontier, empty); });
+}
+
+void KingLayers(Bitboard sources, Bitboard empty, DistanceLayers& out) {
+    floodLayers(sources, empty, out, [](Bitboard frontier) { return KingAttacks(frontier); });
+}
+
+// 距离正好是 d 的空格
+static Bitboard layerAt(const DistanceLayers& l, int d) {
+    return l.within(d) & ~l.within(d - 1);
+}
+
+// 先到者得格：mine 先到的数、theirs 先到的数、同时到的数
+static void countFirstArrivals(const DistanceLayers& mine, const DistanceLayers& theirs, int& mineFirst, int& theirsFirst,
+                               int& ties) {
+    mineFirst = theirsFirst = ties = 0;
+    int layers = std::max(mine.count, theirs.count);
+    for (int d = 1; d <= layers; d++) {
+        Bitboard m = layerAt(mine, d), t = layerAt(theirs, d);
+        mineFirst += PopCount(m & ~theirs.within(d));
+        theirsFirst += PopCount(t & ~mine.within(d));
+        ties += PopCount(m & t);
+    }
+}
+
+// 对 k = 1..6 累加"对方比己方至少远 k 步"的空格数（对方到不了算无穷远），也就是 Σ min(6, 距离差) 里正的部分
+static int countLeads(const DistanceLayers& mine, const DistanceLayers& theirs) {
+    int total = 0;
+    for (int d = 1; d <= mine.count; d++) {
+        Bitboard m = layerAt(mine, d);
+        for (int k = 1; k <= 6; k++) total += PopCount(m & ~theirs.within(d + k - 1));
+    }
+    return total;
+}
+
+TerritoryFeatures TerritoryFromLayers(const DistanceLayers& queenMine, const DistanceLayers& queenTheirs,
+                                      const DistanceLayers& kingMine, const DistanceLayers& kingTheirs, double tie) {
+    TerritoryFeatures f = {0.0, 0.0, 0.0, 0.0};
+    int mineFirst, theirsFirst, ties;
+    countFirstArrivals(queenMine, queenTheirs, mineFirst, theirsFirst, ties);
+    f.t1 = mineFirst - theirsFirst + tie * ties;
+    countFirstArrivals(kingMine, kingTheirs, mineFirst, theirsFirst, ties);
+    f.t2 = mineFirst - theirsFirst + tie * ties;
+    // 2 * Σ (2^-D(己方) - 2^-D(对方))：同一层的格子一起算，到不了的格子贡献为 0
+    int layers = std::max(queenMine.count, queenTheirs.count);
+    for (int d = 1; d <= layers; d++) {
+        f.c1 += 2.0 * std::ldexp(1.0, -d) * (PopCount(layerAt(queenMine, d)) - PopCount(layerAt(queenTheirs, d)));
+    }
+    // Σ clamp((D(对方) - D(己方)) / 6, -1, 1)，距离差按 1..6 逐级计数
+    f.c2 = (countLeads(kingMine, kingTheirs) - countLeads(kingTheirs, kingMine)) / 6.0;
+    return f;
+}
+
+TerritoryFeatures ComputeTerritory(const AmazonBoard& board, int player, int playerToMove) {
+    Bitboard empty = ~board.occupied;
+    DistanceLayers queenMine, queenTheirs, kingMine, kingTheirs;
+    QueenLayers(board.Queens(player), empty, queenMine);
+    QueenLayers(board.Queens(3 - player), empty, queenTheirs);
+    KingLayers(board.Queens(player), empty, kingMine);
+    KingLayers(board.Queens(3 - player), empty, kingTheirs);
+    double tie = (player == playerToMove) ? kTerritoryTieBonus : -kTerritoryTieBonus;
+    return TerritoryFromLayers(queenMine, queenTheirs, kingMine, kingTheirs, tie);
+}
+
+double TerritoryScore(const TerritoryFeatures& f, int arrows) {
+    // 开局领地还没划清，更看重国王距离和位置分；越往后女王距离领地越接近最终结果
+    double score;
+    if (arrows < 14) {
+        score = 0.14 * f.t1 + 0.37 * f.t2 + 0.13 * f.c1 + 0.13 * f.c2;
+    } else if (arrows < 30) {
+        score = 0.30 * f.t1 + 0.25 * f.t2 + 0.20 * f.c1 + 0.20 * f.c2;
+    } else {
+        score = 0.80 * f.t1 + 0.10 * f.t2 + 0.05 * f.c1 + 0.05 * f.c2;
+    }
+    return score;
+}
+
+double TerritoryScore(const AmazonBoard& board, int player, int playerToMove) {
+    return TerritoryScore(ComputeTerritory(board, player, playerToMove), PopCount(board.arrows));
+}
+
+double TerritoryWinProbability(double score) {
+    // 分数差 5 左右已经是明显优势，对应约 73% 的胜率
+    const double kScale = 0.2;
+    return 1.0 / (1.0 + std::exp(-kScale * score));
+}
+
+double EvaluateTerritory(const AmazonBoard& board, int player, int playerToMove) {
+    return TerritoryWinProbability(TerritoryScore(board, player, playerToMove));
+}
+
+double EvaluateMobility(const AmazonBoard& board, int player) {
+    int myMoves = CountMoves(board, player);
+    int enemyMoves = CountMoves(board, 3 - player);
+
+    int total = myMoves + enemyMoves;
+    if (total == 0) {
+        return 0.5; // 双方都被封死
+    }
+    return static_cast<double>(myMoves) / static_cast<double>(total);
+}
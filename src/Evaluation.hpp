@@ -0,0 +1,55 @@
+#ifndef EVALUATION_HPP
+#define EVALUATION_HPP
+
+#include "Board.hpp"
+#include <cstdint>
+
+// 模拟截断后（或不模拟时）给叶子局面打分的方式
+enum LeafEvaluation {
+    EVAL_MOBILITY = 0,  // 合法动作数之比，便宜但信号弱
+    EVAL_TERRITORY = 1  // 女王/国王距离领地，贵一些但准得多，模拟可以短很多
+};
+
+// 领地评估的各项特征，都是 player 视角（正数对 player 有利）。参见 Lieberum 的 AMAZONG 评估
+struct TerritoryFeatures {
+    double t1;  // 女王距离领地：player 先到的空格数减对方先到的，同时到达时算轮到走的一方小优
+    double t2;  // 国王距离领地，同上
+    double c1;  // 女王距离位置分：2 * Σ (2^-D1(己方) - 2^-D1(对方))
+    double c2;  // 国王距离位置分：Σ clamp((D2(对方) - D2(己方)) / 6, -1, 1)
+};
+
+// 洪水填充的逐层结果：reached[d - 1] 是距离不超过 d 的所有空格，count 是最远的距离（之后不再变化）。
+// 领地特征只需要每一层的集合做位运算和 PopCount，不用逐格比较距离
+struct DistanceLayers {
+    Bitboard reached[64];
+    int count;
+
+    // 距离不超过 d 的空格（d 超出最远距离时就是能到的全部空格）
+    Bitboard within(int d) const { return (d <= 0 || count == 0) ? 0 : reached[(d < count ? d : count) - 1]; }
+};
+
+void QueenLayers(Bitboard sources, Bitboard empty, DistanceLayers& out);
+void KingLayers(Bitboard sources, Bitboard empty, DistanceLayers& out);
+
+// 由双方的女王/国王距离层算领地特征，tie 是同时到达的空格给 player 的分（轮到 player 走时为正）
+TerritoryFeatures TerritoryFromLayers(const DistanceLayers& queenMine, const DistanceLayers& queenTheirs,
+                                      const DistanceLayers& kingMine, const DistanceLayers& kingTheirs, double tie);
+
+// 计算领地特征，playerToMove 是轮到谁走（决定同时到达的空格归谁）
+TerritoryFeatures ComputeTerritory(const AmazonBoard& board, int player, int playerToMove);
+
+// 领地评估分：按对局阶段（已经射出的箭数）给各项特征加权，player 视角，大致以"格"为单位
+double TerritoryScore(const AmazonBoard& board, int player, int playerToMove);
+double TerritoryScore(const TerritoryFeatures& f, int arrows);
+// 领地评估分换算成胜率
+double TerritoryWinProbability(double score);
+// 同时到达的空格算轮到走的一方的，但只算一小部分
+const double kTerritoryTieBonus = 0.2;
+
+// 把领地评估分压到 (0, 1) 当作 player 的胜率估计
+double EvaluateTerritory(const AmazonBoard& board, int player, int playerToMove);
+
+// 旧的行动力评估：player 的合法动作数占双方总数的比例
+double EvaluateMobility(const AmazonBoard& board, int player);
+
+#endif
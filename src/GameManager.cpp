@@ -1,5 +1,7 @@
 #include "GameManager.hpp"
+#include "GameRecord.hpp"
 #include <string>
+#include <utility>
 
 // 基础常量定义
 const int screenWidth = 800;
@@ -10,7 +12,7 @@ void GameManager::StartNewGame() {
     history.clear();
     currentPlayer = 2; // 玩家先手
     turn = 1;
-    replayIndex = 0;
+    replay.clear();
     currentScene = PLAYING;
 }//好的这部分是对的
 
@@ -19,63 +21,70 @@ void GameManager::RecordMove(AmazonMove m) {
 }//对的
 
 bool GameManager::SaveGame(const std::string& filename) {
-    FILE* file = fopen(filename.c_str(), "wb");
-    if (!file) return false;
-
-    // 1. 保存基础状态
-    fwrite(&currentPlayer, sizeof(int), 1, file);
-    fwrite(&turn, sizeof(int), 1, file);
-    fwrite(board.grid, sizeof(int), 64, file);
-
-    // 2. 保存历史记录长度和内容
-    int historySize = (int)history.size();
-    fwrite(&historySize, sizeof(int), 1, file);
-    if (historySize > 0) {
-        fwrite(history.data(), sizeof(AmazonMove), historySize, file);
-    }
-
-    fclose(file);
-    return true;
+    // 存档格式见 GameRecord.hpp：带版本号和校验和，动作按 PackedMove 存
+    SavedGame game;
+    game.currentPlayer = currentPlayer;
+    game.turn = turn;
+    game.board = board;
+    game.history = history;
+    return WriteSaveFile(filename, game);
 }
 
 bool GameManager::LoadGame(const std::string& filename) {
-    FILE* file = fopen(filename.c_str(), "rb");
-    if (!file) return false;
-
-    fread(&currentPlayer, sizeof(int), 1, file);
-    fread(&turn, sizeof(int), 1, file);
-    fread(board.grid, sizeof(int), 64, file);
-
-    int historySize;
-    if (fread(&historySize, sizeof(int), 1, file) == 1) {
-        history.resize(historySize);
-        if (historySize > 0) {
-            fread(history.data(), sizeof(AmazonMove), historySize, file);
-        }
+    // 旧版（全 int 布局）的存档也能读；文件坏了就保持当前对局不变
+    SavedGame game;
+    if (!ReadSaveFile(filename, game)) return false;
+    GameReplay check;
+    if (!check.load(game.history) || check.finalBoard() != game.board ||
+        game.currentPlayer != GameReplay::PlayerOfPly(check.size())) {
+        return false;
     }
-
-    fclose(file);
+    currentPlayer = game.currentPlayer;
+    turn = game.turn;
+    board = game.board;
+    history = std::move(game.history);
     currentScene = PLAYING;
     return true;
 }
 
 
 void GameManager::EnterReplayMode() {
-    board = AmazonBoard(); 
-    replayIndex = 0;
+    // 历史在落子和读档时都检查过，这里只是建快照
+    replay.load(history);
     currentScene = REPLAY;
-}//有点问题！！！！（不对没问题）
+}
 
 void GameManager::NextReplayStep() {
-    if (replayIndex < (int)history.size()) {
-        AmazonMove m = history[replayIndex];
-        int p = (replayIndex % 2 == 0) ? 2 : 1; 
-        board.SetPiece(m.qx1, m.qy1, EMPTY);
-        board.SetPiece(m.qx2, m.qy2, p);
-        board.SetPiece(m.ax, m.ay, ARROW);
-        replayIndex++;
+    replay.stepForward();
+}
+
+void GameManager::PrevReplayStep() {
+    replay.stepBackward();
+}
+
+void GameManager::SeekReplay(int ply) {
+    replay.seek(ply);
+}
+
+// 复盘进度条：棋盘最下面一条
+const int replayBarY = 800 - 16;
+
+void GameManager::HandleReplayInput() {
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+        Vector2 mPos = GetMousePosition();
+        if (mPos.y >= replayBarY && replay.size() > 0) {
+            SeekReplay((int)(mPos.x / screenWidth * replay.size() + 0.5f));
+        } else {
+            NextReplayStep();
+        }
     }
-}//对的
+    if (IsKeyPressed(KEY_RIGHT)) NextReplayStep();
+    if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT) || IsKeyPressed(KEY_LEFT)) PrevReplayStep();
+    if (IsKeyPressed(KEY_HOME)) SeekReplay(0);
+    if (IsKeyPressed(KEY_END)) SeekReplay(replay.size());
+    if (IsKeyPressed(KEY_PAGE_DOWN)) SeekReplay(replay.ply() + 10);
+    if (IsKeyPressed(KEY_PAGE_UP)) SeekReplay(replay.ply() - 10);
+}
 
 // --- 新增：绘制主入口 ---
 void GameManager::Draw(int gameState, Vector2 selectedIdx, bool isGameOver) {
@@ -91,13 +100,22 @@ void GameManager::Draw(int gameState, Vector2 selectedIdx, bool isGameOver) {
             DrawRectangleLines(250, 420, 300, 50, DARKGREEN);
             DrawText("Press [L] Load Game", 285, 435, 20, DARKGREEN);
         }
+        DrawText(TextFormat("[E] Engine: %s", engineName.c_str()), 285, 500, 20, DARKBLUE);
     } 
     else {
+        // 复盘时画复盘游标的棋盘，并标出刚走的那一步
+        const AmazonBoard& shown = (currentScene == REPLAY) ? replay.board() : board;
+        AmazonMove lastMove;
+        bool hasLastMove = (currentScene == REPLAY) && replay.lastMove(lastMove);
         // 绘制棋盘背景和格位
         for (int y = 0; y < 8; y++) {
             for (int x = 0; x < 8; x++) {
                 Color tileColor = ((x + y) % 2 == 0) ? Color{240, 217, 181, 255} : Color{181, 136, 99, 255};
                 DrawRectangle(x * cellSize, y * cellSize, cellSize, cellSize, tileColor);
+                if (hasLastMove && ((x == lastMove.qx1 && y == lastMove.qy1) || (x == lastMove.qx2 && y == lastMove.qy2) ||
+                                    (x == lastMove.ax && y == lastMove.ay))) {
+                    DrawRectangle(x * cellSize, y * cellSize, cellSize, cellSize, Fade(SKYBLUE, 0.5f));
+                }
 
                 // 绘制玩家操作高亮
                 if (currentScene == PLAYING && currentPlayer == 2 && !isGameOver) {
@@ -110,7 +128,7 @@ void GameManager::Draw(int gameState, Vector2 selectedIdx, bool isGameOver) {
                 }
 
                 // 绘制棋子
-                int piece = board.grid[y][x];
+                int piece = shown.GetPiece(x, y);
                 if (piece == WHITE_QUEEN) DrawCircle(x*cellSize + cellSize/2, y*cellSize + cellSize/2, cellSize*0.4, WHITE);
                 else if (piece == BLACK_QUEEN) DrawCircle(x*cellSize + cellSize/2, y*cellSize + cellSize/2, cellSize*0.4, BLACK);
                 else if (piece == ARROW) DrawPoly({(float)x*cellSize + cellSize/2, (float)y*cellSize + cellSize/2}, 4, cellSize*0.3, 45, RED);
@@ -121,13 +139,18 @@ void GameManager::Draw(int gameState, Vector2 selectedIdx, bool isGameOver) {
         DrawRectangle(0, 0, 800, 40, Fade(BLACK, 0.6f));
         std::string statusText = (currentScene == REPLAY) ? "REPLAY MODE" : (currentPlayer == 2 ? "YOUR TURN" : "BOT THINKING...");
         DrawText(statusText.c_str(), 20, 10, 20, GOLD);
-        DrawText(TextFormat("TURN: %d", currentScene == PLAYING ? turn : (replayIndex == history.size() ? -1 : (replayIndex+1)/2)), 680, 10, 20, WHITE);
-
         if (currentScene == PLAYING) {
-            DrawText("[S] SAVE | [R] REPLAY | [TAB] MENU", 250, 10, 18, LIGHTGRAY);
+            DrawText(TextFormat("TURN: %d", turn), 680, 10, 20, WHITE);
+            DrawText("[S] SAVE | [R] REPLAY | [F3] STATS | [TAB] MENU", 200, 10, 18, LIGHTGRAY);
         } else {
-            DrawText("CLICK MOUSE FOR NEXT STEP | [TAB] MENU", 220, 10, 18, LIGHTGRAY);
+            DrawText(TextFormat("%d / %d", replay.ply(), replay.size()), 680, 10, 20, WHITE);
+            DrawText("<- -> STEP | HOME END | [R] BACK", 250, 10, 18, LIGHTGRAY);
+            // 进度条：点哪儿跳到哪儿
+            DrawRectangle(0, replayBarY, 800, 800 - replayBarY, Fade(BLACK, 0.6f));
+            int filled = replay.size() > 0 ? 800 * replay.ply() / replay.size() : 0;
+            DrawRectangle(0, replayBarY + 4, filled, 800 - replayBarY - 8, GOLD);
         }
+        if (showStats && currentScene == PLAYING) DrawStatsOverlay();
         // 游戏结束层
         if (isGameOver) {
             DrawRectangle(0, 0, 800, 800, Fade(BLACK, 0.5f));
@@ -136,4 +159,44 @@ void GameManager::Draw(int gameState, Vector2 selectedIdx, bool isGameOver) {
         }
     }
     return ;
-}
\ No newline at end of file
+}
+
+void GameManager::DrawStatsOverlay() {
+    const SearchStats& st = searchStats;
+    int x = 10, y = 50, lineHeight = 20;
+    int lines = 4 + (int)st.topMoves.size() + (st.phasesTimed ? kNumSearchPhases + 1 : 0);
+    DrawRectangle(0, 40, 360, lines * lineHeight + 20, Fade(BLACK, 0.7f));
+
+    const char* state = st.fromBook ? "book" : st.solved ? "solved" : st.pondering ? "pondering" : st.searching ? "searching" : "done";
+    DrawText(TextFormat("%s  [%s]", engineName.c_str(), state), x, y, 18, GOLD);
+    y += lineHeight;
+    DrawText(TextFormat("time %.2fs  iters %llu  (%.1fk/s)", st.seconds, (unsigned long long)st.iterations,
+                        st.iterationsPerSecond / 1000.0), x, y, 16, WHITE);
+    y += lineHeight;
+    if (st.treeNodes > 0) {
+        DrawText(TextFormat("tree %zu nodes  depth %d  prunes %d", st.treeNodes, st.maxDepth, st.prunes), x, y, 16, WHITE);
+    } else {
+        DrawText(TextFormat("depth %d  score %d", st.maxDepth, st.score), x, y, 16, WHITE);
+    }
+    y += lineHeight;
+    DrawText("top moves:", x, y, 16, LIGHTGRAY);
+    y += lineHeight;
+    for (const RootChildStats& c : st.topMoves) {
+        const AmazonMove& m = c.move;
+        DrawText(TextFormat("  %d,%d -> %d,%d  x %d,%d   %u visits  %.1f%%", m.qx1, m.qy1, m.qx2, m.qy2, m.ax, m.ay,
+                            c.visits, c.winRate * 100.0), x, y, 16, WHITE);
+        y += lineHeight;
+    }
+    if (st.phasesTimed) {
+        double total = 0.0;
+        for (double t : st.phaseSeconds) total += t;
+        DrawText("phases (all threads):", x, y, 16, LIGHTGRAY);
+        y += lineHeight;
+        for (int p = 0; p < kNumSearchPhases; p++) {
+            double share = total > 0.0 ? st.phaseSeconds[p] / total : 0.0;
+            DrawRectangle(x + 90, y + 3, (int)(200 * share), 12, SKYBLUE);
+            DrawText(TextFormat("  %-9s %4.1f%%", SearchPhaseName(p), share * 100.0), x, y, 16, WHITE);
+            y += lineHeight;
+        }
+    }
+}
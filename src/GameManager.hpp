@@ -4,6 +4,7 @@
 #include "raylib.h"
 #include "Board.hpp"
 #include "MCTS.hpp"
+#include "Replay.hpp"
 #include <vector>
 #include <string>
 
@@ -15,24 +16,35 @@ public:
     GameScene currentScene = MENU;
     int currentPlayer = 2; // 1: Bot, 2: Player
     int turn = 1;
-    int replayIndex = 0;   // 复盘进度指针
+    std::string engineName; // bot 当前用的搜索引擎，菜单里显示
+    bool showStats = false;  // 是否在棋盘上叠加显示搜索统计（[F3] 切换）
+    SearchStats searchStats; // bot 最近一次（或正在进行的）搜索的统计，主循环每帧更新
 
     // --- 数据对象 ---
     AmazonBoard board;
     std::vector<AmazonMove> history; // 动作历史记录
+    GameReplay replay;               // 复盘游标，有自己的棋盘，复盘时不动 board
 
     // --- 核心逻辑函数 ---
     void StartNewGame();
     bool SaveGame(const std::string& filename);
+    // 读档时按规则重走历史：有不合法的动作、重走出来的局面和存档对不上、轮到谁走对不上，都当坏档拒绝
     bool LoadGame(const std::string& filename);
     void RecordMove(AmazonMove m);
 
     // --- 复盘功能函数 ---
     void EnterReplayMode();
     void NextReplayStep();
+    void PrevReplayStep();
+    void SeekReplay(int ply);
+    // 复盘时的按键和鼠标：左键/→ 下一步，右键/← 上一步，Home/End 跳到头尾，PageUp/PageDown 跳 10 步，
+    // 点底部进度条跳到对应的步数
+    void HandleReplayInput();
 
     // --- UI 与 绘图函数 ---
     // 传入 gameState(阶段), selectedIdx(选子坐标), isGameOver(结束标志) 供界面渲染
     void Draw(int gameState, Vector2 selectedIdx, bool isGameOver);
+    // 搜索统计面板：用时、迭代速度、树大小、深度、访问数最多的几个动作、各阶段用时
+    void DrawStatsOverlay();
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,354 @@
+#include "GameRecord.hpp"
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+uint32_t RecordChecksum(const void* data, size_t size, uint32_t h) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// ---- 单盘存档 ----
+
+static bool ReadWholeFile(const std::string& path, std::vector<char>& bytes) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    bytes.clear();
+    char buffer[4096];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + n);
+    }
+    bool ok = !std::ferror(f);
+    std::fclose(f);
+    return ok;
+}
+
+// 一盘棋最多 64 - 8 = 56 步（每步射一支箭）
+const uint32_t kMaxPlies = 56;
+
+static bool ValidMove(PackedMove m) {
+    return (m.bits >> 18) == 0 && m.from() != m.to();
+}
+
+// 旧格式：全是 int，格子和动作都原样写进去
+static bool ReadLegacySave(const std::vector<char>& bytes, SavedGame& game) {
+    const size_t fixed = sizeof(int32_t) * (2 + 64 + 1);
+    if (bytes.size() < fixed) return false;
+    int32_t head[2 + 64 + 1];
+    std::memcpy(head, bytes.data(), fixed);
+    int32_t historySize = head[66];
+    if (historySize < 0 || static_cast<uint32_t>(historySize) > kMaxPlies) return false;
+    if (bytes.size() < fixed + static_cast<size_t>(historySize) * 6 * sizeof(int32_t)) return false;
+
+    SavedGame loaded;
+    loaded.currentPlayer = head[0];
+    loaded.turn = head[1];
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            int piece = head[2 + y * 8 + x];
+            if (piece < EMPTY || piece > ARROW) return false;
+            loaded.board.SetPiece(x, y, piece);
+        }
+    }
+    for (int32_t i = 0; i < historySize; i++) {
+        int32_t v[6];
+        std::memcpy(v, bytes.data() + fixed + static_cast<size_t>(i) * sizeof(v), sizeof(v));
+        for (int32_t c : v) {
+            if (c < 0 || c > 7) return false;
+        }
+        loaded.history.push_back(AmazonMove(v[0], v[1], v[2], v[3], v[4], v[5]));
+    }
+    game = std::move(loaded);
+    return true;
+}
+
+bool WriteSaveFile(const std::string& path, const SavedGame& game) {
+    SaveHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, "AMZSAVE", 8);
+    h.version = kSaveVersion;
+    h.historySize = static_cast<uint32_t>(game.history.size());
+    h.currentPlayer = game.currentPlayer;
+    h.turn = game.turn;
+    h.white = game.board.white;
+    h.black = game.board.black;
+    h.arrows = game.board.arrows;
+
+    std::vector<uint32_t> moves;
+    moves.reserve(game.history.size());
+    for (const AmazonMove& m : game.history) moves.push_back(PackedMove(m).bits);
+    uint32_t checksum = RecordChecksum(&h, sizeof(h));
+    checksum = RecordChecksum(moves.data(), moves.size() * sizeof(uint32_t), checksum);
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+              std::fwrite(moves.data(), sizeof(uint32_t), moves.size(), f) == moves.size() &&
+              std::fwrite(&checksum, sizeof(checksum), 1, f) == 1;
+    return std::fclose(f) == 0 && ok;
+}
+
+bool ReadSaveFile(const std::string& path, SavedGame& game) {
+    std::vector<char> bytes;
+    if (!ReadWholeFile(path, bytes)) return false;
+    if (bytes.size() < sizeof(SaveHeader) || std::memcmp(bytes.data(), "AMZSAVE", 8) != 0) {
+        return ReadLegacySave(bytes, game);
+    }
+
+    SaveHeader h;
+    std::memcpy(&h, bytes.data(), sizeof(h));
+    if (h.version != kSaveVersion || h.historySize > kMaxPlies) return false;
+    size_t movesSize = h.historySize * sizeof(uint32_t);
+    if (bytes.size() != sizeof(h) + movesSize + sizeof(uint32_t)) return false;
+    uint32_t stored;
+    std::memcpy(&stored, bytes.data() + sizeof(h) + movesSize, sizeof(stored));
+    if (RecordChecksum(bytes.data(), sizeof(h) + movesSize) != stored) return false;
+    // 三张位棋盘不能重叠，每方最多 4 个女王
+    if ((h.white & h.black) || (h.white & h.arrows) || (h.black & h.arrows)) return false;
+    if (PopCount(h.white) > 4 || PopCount(h.black) > 4) return false;
+    if (h.currentPlayer != WHITE_QUEEN && h.currentPlayer != BLACK_QUEEN) return false;
+
+    SavedGame loaded;
+    loaded.currentPlayer = h.currentPlayer;
+    loaded.turn = h.turn;
+    for (int sq = 0; sq < 64; sq++) {
+        Bitboard bit = SquareBit(sq);
+        int piece = (h.white & bit) ? WHITE_QUEEN : (h.black & bit) ? BLACK_QUEEN : (h.arrows & bit) ? ARROW : EMPTY;
+        loaded.board.SetPiece(SquareX(sq), SquareY(sq), piece);
+    }
+    loaded.history.reserve(h.historySize);
+    for (uint32_t i = 0; i < h.historySize; i++) {
+        uint32_t bits;
+        std::memcpy(&bits, bytes.data() + sizeof(h) + i * sizeof(uint32_t), sizeof(bits));
+        if (!ValidMove(PackedMove(bits))) return false;
+        loaded.history.push_back(PackedMove(bits).unpack());
+    }
+    game = std::move(loaded);
+    return true;
+}
+
+// ---- 对局库 ----
+
+// 对局库可能超过 2GB，Windows 上 long 只有 32 位
+static bool SeekTo(FILE* f, uint64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(f, static_cast<long long>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(f, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+static uint64_t FileSize(FILE* f) {
+#ifdef _WIN32
+    _fseeki64(f, 0, SEEK_END);
+    return static_cast<uint64_t>(_ftelli64(f));
+#else
+    fseeko(f, 0, SEEK_END);
+    return static_cast<uint64_t>(ftello(f));
+#endif
+}
+
+static uint64_t AlignIndex(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+static uint32_t GameChecksum(const ArchivedGameHeader& h, const uint32_t* moves) {
+    uint32_t c = RecordChecksum(&h, offsetof(ArchivedGameHeader, checksum));
+    return RecordChecksum(moves, h.plies * sizeof(uint32_t), c);
+}
+
+bool ArchivedGame::verify() const {
+    return valid() && GameChecksum(*header, moves) == header->checksum;
+}
+
+bool GameArchive::open(const std::string& path) {
+    close();
+    if (!file.open(path) || file.size() < sizeof(ArchiveHeader)) {
+        close();
+        return false;
+    }
+    const ArchiveHeader* h = reinterpret_cast<const ArchiveHeader*>(file.data());
+    uint64_t size = file.size();
+    bool valid = std::memcmp(h->magic, "AMZARCH", 8) == 0 && h->version == kArchiveVersion &&
+                 h->indexOffset >= sizeof(ArchiveHeader) && h->indexOffset % 8 == 0 && h->indexOffset <= size &&
+                 h->gameCount <= (size - h->indexOffset) / sizeof(uint64_t);
+    if (!valid) {
+        close();
+        return false;
+    }
+    const uint64_t* idx = reinterpret_cast<const uint64_t*>(file.data() + h->indexOffset);
+    // 偏移表是唯一需要整体读一遍的东西（每盘 8 字节），对局记录本身用到时才碰
+    if (RecordChecksum(idx, h->gameCount * sizeof(uint64_t)) != h->indexChecksum) {
+        close();
+        return false;
+    }
+    header = h;
+    index = idx;
+    return true;
+}
+
+void GameArchive::close() {
+    file.close();
+    header = nullptr;
+    index = nullptr;
+}
+
+ArchivedGame GameArchive::game(size_t i) const {
+    ArchivedGame g;
+    if (i >= size()) return g;
+    uint64_t offset = index[i];
+    if (offset < sizeof(ArchiveHeader) || offset % 4 != 0 || offset + sizeof(ArchivedGameHeader) > header->indexOffset) {
+        return g;
+    }
+    const ArchivedGameHeader* h = reinterpret_cast<const ArchivedGameHeader*>(file.data() + offset);
+    if (offset + sizeof(ArchivedGameHeader) + h->plies * sizeof(uint32_t) > header->indexOffset) return g;
+    g.header = h;
+    g.moves = reinterpret_cast<const uint32_t*>(h + 1);
+    return g;
+}
+
+GameArchiveWriter::~GameArchiveWriter() {
+    close();
+}
+
+bool GameArchiveWriter::open(const std::string& path) {
+    close();
+    offsets.clear();
+    file = std::fopen(path.c_str(), "r+b");
+    if (!file) {
+        // 新文件：先写一个空库的文件头
+        file = std::fopen(path.c_str(), "w+b");
+        if (!file) return false;
+        end = sizeof(ArchiveHeader);
+        dirty = true;
+        if (!flush()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t fileSize = FileSize(file);
+    ArchiveHeader h;
+    SeekTo(file, 0);
+    if (fileSize < sizeof(h) || std::fread(&h, sizeof(h), 1, file) != 1 || std::memcmp(h.magic, "AMZARCH", 8) != 0 ||
+        h.version != kArchiveVersion) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    bool indexOk = h.indexOffset >= sizeof(h) && h.indexOffset <= fileSize &&
+                   h.gameCount <= (fileSize - h.indexOffset) / sizeof(uint64_t);
+    if (indexOk) {
+        offsets.resize(h.gameCount);
+        SeekTo(file, h.indexOffset);
+        indexOk = std::fread(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size() &&
+                  RecordChecksum(offsets.data(), offsets.size() * sizeof(uint64_t)) == h.indexChecksum;
+        // 新记录紧接着最后一盘写（偏移表前面的对齐空隙也覆盖掉），这样记录始终首尾相连，修复时能顺着扫
+        end = sizeof(h);
+        if (indexOk && !offsets.empty()) {
+            ArchivedGameHeader last;
+            SeekTo(file, offsets.back());
+            indexOk = std::fread(&last, sizeof(last), 1, file) == 1;
+            end = offsets.back() + sizeof(last) + last.plies * sizeof(uint32_t);
+        }
+        // 干净 flush 之后偏移表正好在文件末尾；后面还有东西说明上次追加了记录没来得及 flush
+        indexOk = indexOk && AlignIndex(end) == h.indexOffset &&
+                  fileSize == h.indexOffset + offsets.size() * sizeof(uint64_t);
+    }
+    if (!indexOk && !recover(fileSize)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// 文件头和偏移表对不上（上次追加到一半就断了）：从头顺着记录扫，校验和对得上的都留下
+bool GameArchiveWriter::recover(uint64_t fileSize) {
+    offsets.clear();
+    uint64_t offset = sizeof(ArchiveHeader);
+    std::vector<uint32_t> moves;
+    while (offset + sizeof(ArchivedGameHeader) <= fileSize) {
+        ArchivedGameHeader h;
+        SeekTo(file, offset);
+        if (std::fread(&h, sizeof(h), 1, file) != 1 || h.plies > kMaxPlies) break;
+        moves.resize(h.plies);
+        if (std::fread(moves.data(), sizeof(uint32_t), moves.size(), file) != moves.size()) break;
+        if (GameChecksum(h, moves.data()) != h.checksum) break;
+        offsets.push_back(offset);
+        offset += sizeof(h) + moves.size() * sizeof(uint32_t);
+    }
+    end = offset;
+    dirty = true;
+    if (!flush()) return false;
+    // 截掉扫描停下之后的残留，免得下次打开又要修一遍
+    uint64_t valid = AlignIndex(end) + offsets.size() * sizeof(uint64_t);
+#ifdef _WIN32
+    return _chsize_s(_fileno(file), static_cast<long long>(valid)) == 0;
+#else
+    return ftruncate(fileno(file), static_cast<off_t>(valid)) == 0;
+#endif
+}
+
+bool GameArchiveWriter::append(const std::vector<AmazonMove>& moves, int winner, int openingPlies) {
+    if (!file || moves.size() > kMaxPlies) return false;
+    ArchivedGameHeader h;
+    h.plies = static_cast<uint16_t>(moves.size());
+    h.winner = static_cast<uint8_t>(winner);
+    h.openingPlies = static_cast<uint8_t>(openingPlies);
+    uint32_t packed[kMaxPlies];
+    for (size_t i = 0; i < moves.size(); i++) packed[i] = PackedMove(moves[i]).bits;
+    h.checksum = GameChecksum(h, packed);
+
+    SeekTo(file, end);
+    if (std::fwrite(&h, sizeof(h), 1, file) != 1 || std::fwrite(packed, sizeof(uint32_t), moves.size(), file) != moves.size()) {
+        return false;
+    }
+    offsets.push_back(end);
+    end += sizeof(h) + moves.size() * sizeof(uint32_t);
+    dirty = true;
+    return true;
+}
+
+bool GameArchiveWriter::flush() {
+    if (!file) return false;
+    if (!dirty) return true;
+    uint64_t indexOffset = AlignIndex(end);
+    static const char zeros[8] = {};
+    SeekTo(file, end);
+    bool ok = std::fwrite(zeros, 1, indexOffset - end, file) == indexOffset - end &&
+              std::fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size() &&
+              std::fflush(file) == 0;
+    if (!ok) return false;
+
+    // 偏移表落盘之后才改文件头
+    ArchiveHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, "AMZARCH", 8);
+    h.version = kArchiveVersion;
+    h.gameCount = offsets.size();
+    h.indexOffset = indexOffset;
+    h.indexChecksum = RecordChecksum(offsets.data(), offsets.size() * sizeof(uint64_t));
+    SeekTo(file, 0);
+    ok = std::fwrite(&h, sizeof(h), 1, file) == 1 && std::fflush(file) == 0;
+    // 下一盘记录还是从对齐前的位置写，偏移表下次 flush 时整体后移
+    dirty = !ok;
+    return ok;
+}
+
+bool GameArchiveWriter::close() {
+    if (!file) return true;
+    bool ok = flush();
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    return ok;
+}
@@ -0,0 +1,125 @@
+#ifndef GAME_RECORD_HPP
+#define GAME_RECORD_HPP
+
+#include "Board.hpp"
+#include "MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// 对局记录的磁盘格式：单盘存档（界面的保存/读取）和多盘对局库（自对弈、分析工具）。
+// 动作一律按 PackedMove 存，每步 4 字节，数据都带校验和
+
+// FNV-1a 32 位校验和，h 传上一段的结果可以分段累加
+uint32_t RecordChecksum(const void* data, size_t size, uint32_t h = 2166136261u);
+
+// ---- 单盘存档 ----
+// 新格式：SaveHeader + historySize 个 uint32_t 动作 + 前面所有字节的校验和。
+// 旧格式（int currentPlayer, int turn, int grid[8][8], int historySize, 每步 6 个 int）照样能读
+struct SaveHeader {
+    char magic[8];          // "AMZSAVE\0"
+    uint32_t version;       // kSaveVersion
+    uint32_t historySize;
+    int32_t currentPlayer;
+    int32_t turn;
+    uint64_t white, black, arrows;
+};
+
+const uint32_t kSaveVersion = 2;
+
+struct SavedGame {
+    int currentPlayer = BLACK_QUEEN;
+    int turn = 1;
+    AmazonBoard board;
+    std::vector<AmazonMove> history;
+};
+
+bool WriteSaveFile(const std::string& path, const SavedGame& game);
+// 读新旧两种格式，文件不存在、截断、校验和不对或者棋盘不合理时返回 false，game 不动
+bool ReadSaveFile(const std::string& path, SavedGame& game);
+
+// ---- 多盘对局库 ----
+// 只追加的文件：ArchiveHeader，然后一盘接一盘的记录（ArchivedGameHeader + plies 个 uint32_t 动作），
+// 最后是每盘记录起点的 uint64_t 偏移表。追加时新记录紧接着上一盘写（覆盖旧的偏移表），写完再写新的偏移表，最后改文件头。
+// 写到一半进程没了的话文件头和偏移表对不上，下次用 GameArchiveWriter 打开时顺着记录重新扫一遍就能修好
+struct ArchiveHeader {
+    char magic[8];          // "AMZARCH\0"
+    uint32_t version;       // kArchiveVersion
+    uint32_t indexChecksum; // 偏移表的校验和
+    uint64_t gameCount;
+    uint64_t indexOffset;   // 偏移表在文件里的位置，8 字节对齐
+};
+
+struct ArchivedGameHeader {
+    uint16_t plies;
+    uint8_t winner;         // WHITE_QUEEN、BLACK_QUEEN，0 表示没下完
+    uint8_t openingPlies;   // 前几步是随机开局或者开局库给的
+    uint32_t checksum;      // 前 4 个字节和所有动作的校验和
+};
+
+const uint32_t kArchiveVersion = 1;
+
+// 映射出来的一盘棋，直接指着文件内容，不复制
+class ArchivedGame {
+public:
+    bool valid() const { return header != nullptr; }
+    int plies() const { return header->plies; }
+    int winner() const { return header->winner; }
+    int openingPlies() const { return header->openingPlies; }
+    PackedMove move(int i) const { return PackedMove(moves[i]); }
+    // 重新算校验和，和记录里的比
+    bool verify() const;
+
+private:
+    friend class GameArchive;
+    const ArchivedGameHeader* header = nullptr;
+    const uint32_t* moves = nullptr;
+};
+
+// 只读的对局库，整个文件映射进内存，按下标 O(1) 取任意一盘。可以多个线程同时读
+class GameArchive {
+public:
+    // 映射并校验文件头和偏移表，失败时返回 false
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return index != nullptr; }
+    size_t size() const { return isOpen() ? static_cast<size_t>(header->gameCount) : 0; }
+    // 第 i 盘；偏移表指到文件外面的话返回 valid() 为 false 的空记录
+    ArchivedGame game(size_t i) const;
+
+private:
+    MappedFile file;
+    const ArchiveHeader* header = nullptr;
+    const uint64_t* index = nullptr;
+};
+
+// 往对局库末尾追加对局。同一时间只能有一个 writer 打开同一个文件
+class GameArchiveWriter {
+public:
+    GameArchiveWriter() = default;
+    ~GameArchiveWriter();
+    GameArchiveWriter(const GameArchiveWriter&) = delete;
+    GameArchiveWriter& operator=(const GameArchiveWriter&) = delete;
+
+    // 文件不存在就新建；已经是对局库就接着往后写；是别的文件则返回 false，不会覆盖
+    bool open(const std::string& path);
+    // 记录立刻写进文件，偏移表和文件头要等 flush
+    bool append(const std::vector<AmazonMove>& moves, int winner, int openingPlies);
+    // 写偏移表和文件头，之后 GameArchive 就能看到这之前追加的所有对局
+    bool flush();
+    // flush 后关闭
+    bool close();
+    size_t size() const { return offsets.size(); }
+
+private:
+    bool recover(uint64_t fileSize);
+
+    FILE* file = nullptr;
+    std::vector<uint64_t> offsets;
+    uint64_t end = 0;   // 下一盘记录写在哪（也就是偏移表的起点）
+    bool dirty = false;
+};
+
+#endif
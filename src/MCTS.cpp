@@ -1,192 +1,437 @@
 #include "MCTS.hpp"
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <random>
 #include <map>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
 
-AmazonMove MCTS::GetBestMove(AmazonBoard currentBoard, int aiPlayer, int iterations) {
-    // 先检查根节点是否有合法走法，没有就直接返回一个空动作
-    std::vector<AmazonMove> rootMoves = getAllLegalMoves(currentBoard, aiPlayer);
-    if (rootMoves.empty()) {
-        return AmazonMove{0, 0, 0, 0, 0, 0};
+// 第一次访问节点时数出合法动作数，并随机选一个展开顺序，避免孩子总是按生成顺序扎堆在同一个女王上
+// 调用方持有节点的锁；步长写好之后才发布动作数，其他线程看到动作数就能放心用步长
+static void initUntried(MCTSNode& node, const AmazonBoard& board, std::mt19937& rng) {
+    int n = CountMoves(board, node.playerToMove);
+    if (n > 1) {
+        std::uniform_int_distribution<int> dist(1, n - 1);
+        int stride = dist(rng);
+        while (std::gcd(stride, n) != 1) {
+            stride = dist(rng);
+        }
+        node.untriedStride = static_cast<int16_t>(stride);
+        node.untriedOffset = static_cast<int16_t>(dist(rng));
     }
+    node.numLegalMoves.store(static_cast<int16_t>(n), std::memory_order_release);
+}
 
-    auto root = std::make_unique<MCTSNode>(currentBoard, aiPlayer);
-
-    // 使用一个固定的随机数引擎，比 rand() 更稳定
-    static thread_local std::mt19937 rng(std::random_device{}());
+MCTS::MCTS() : tree(new SearchTree), spareTree(new SearchTree) {}
 
-    for (int i = 0; i < iterations; ++i) {
-        MCTSNode* node = root.get();
+MCTS::~MCTS() {
+    StopSearch();
+}
 
-        // 1. Selection：沿着 UCB1 一直往下走，直到叶子或终局
-        while (!node->children.empty()) {
-            // 如果这个节点已经无子可走，相当于终局，直接停止选择
-            if (getAllLegalMoves(node->board, node->playerToMove).empty()) {
-                break;
-            }
-            node = node->selectChild();
-        }
+WorkerPool& MCTS::workers() {
+    int threads = config.numThreads;
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (!pool || pool->size() != threads) {
+        pool.reset(new WorkerPool(threads));
+    }
+    return *pool;
+}
 
-        // 2. Expansion：如果不是终局，则展开一次（生成子节点）
-        std::vector<AmazonMove> moves = getAllLegalMoves(node->board, node->playerToMove);
-        if (!moves.empty()) {
-            if (node->children.empty()) {
-                node->children.reserve(moves.size());
-                for (auto& m : moves) {
-                    AmazonBoard nextBoard = node->board;
-                    // 执行动作
-                    nextBoard.grid[m.qy1][m.qx1] = EMPTY;
-                    nextBoard.grid[m.qy2][m.qx2] = node->playerToMove;
-                    nextBoard.grid[m.ay][m.ax] = ARROW;
-
-                    auto newNode = std::make_unique<MCTSNode>(nextBoard, 3 - node->playerToMove, node);
-                    newNode->move = m;
-                    node->children.push_back(std::move(newNode));
-                }
-            }
+bool MCTS::prepareRoot(const AmazonBoard& currentBoard, int aiPlayer) {
+    // 先检查根节点是否有合法走法
+    rootFallback = AmazonMove{0, 0, 0, 0, 0, 0};
+    if (!MoveAtIndex(currentBoard, aiPlayer, 0, rootFallback)) {
+        return false;
+    }
 
-            // 从当前节点的孩子中选择一个用于模拟：优先选未访问的，否则再用 UCB
-            MCTSNode* next = nullptr;
-            for (auto& ch : node->children) {
-                if (ch->visits == 0) {
-                    next = ch.get();
-                    break;
-                }
-            }
-            if (!next && !node->children.empty()) {
-                next = node->selectChild();
-            }
-            if (next) {
-                node = next;
-            }
-        }
+    // 上一次搜索（加上 AdvanceRoot 推进）留下的树根就是当前局面时，接着用它积累的统计
+    bool ranked = config.selection != SELECT_UCB1;
+    if (tree->root == kNullNode || treeBoard != currentBoard || tree->node(tree->root).playerToMove != aiPlayer ||
+        treeRanked != ranked) {
+        tree->resetRoot(aiPlayer);
+        treeBoard = currentBoard;
+        treeRanked = ranked;
+    }
+    return true;
+}
 
-        // 3. Simulation：从选中的节点开始随机模拟，对 AI 视角打分
-        double result = simulate(node->board, node->playerToMove, aiPlayer);
+AmazonMove MCTS::GetBestMove(AmazonBoard currentBoard, int aiPlayer, int iterations) {
+    SearchLimits limits;
+    limits.iterations = iterations;
+    return GetBestMove(currentBoard, aiPlayer, limits);
+}
 
-        // 4. Backpropagation：沿父链回溯，将结果累加到路径上的所有节点
-        MCTSNode* back = node;
-        while (back) {
-            back->visits++;
-            back->wins += result; // result 始终是从 aiPlayer 视角的“好坏”
-            back = back->parent;
+AmazonMove MCTS::mostVisitedChild(const SearchTree& t) const {
+    // 选访问次数最多的根节点子节点作为最终落子：只被访问过一两次的孩子平均分很不可靠
+    AmazonMove bestMove = rootFallback;
+    if (t.root == kNullNode) return bestMove;
+    uint32_t bestVisits = 0;
+    const MCTSNode& r = t.node(t.root);
+    int n = r.numChildren(); // 先读孩子数（acquire），再读链接
+    NodeIndex c = n > 0 ? r.firstChild : kNullNode; // 没有孩子时 firstChild 可能正被别的线程写
+    for (int k = 0; k < n; k++) {
+        const MCTSNode& child = t.node(c);
+        uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        if (visits > bestVisits) {
+            bestVisits = visits;
+            bestMove = child.move.unpack();
         }
+        if (k + 1 < n) c = child.nextSibling;
     }
+    return bestMove;
+}
 
-    // 选平均得分最高的根节点子节点作为最终落子
-    AmazonMove bestMove = rootMoves[0];
-    double bestScore = -1.0;
-    for (auto& child : root->children) {
-        if (child->visits == 0) continue;
-        double avg = child->wins / static_cast<double>(child->visits);
-        if (avg > bestScore) {
-            bestScore = avg;
-            bestMove = child->move;
-        }
+std::vector<RootChildStats> MCTS::rootChildren(const SearchTree& t, size_t limit) {
+    std::vector<RootChildStats> stats;
+    if (t.root == kNullNode) return stats;
+    const MCTSNode& r = t.node(t.root);
+    int n = r.numChildren();
+    NodeIndex c = n > 0 ? r.firstChild : kNullNode;
+    for (int k = 0; k < n; k++) {
+        const MCTSNode& child = t.node(c);
+        uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        stats.push_back({child.move.unpack(), visits, visits ? child.wins() / visits : 0.5});
+        if (k + 1 < n) c = child.nextSibling;
     }
-    return bestMove;
+    std::stable_sort(stats.begin(), stats.end(),
+                     [](const RootChildStats& a, const RootChildStats& b) { return a.visits > b.visits; });
+    if (limit > 0 && stats.size() > limit) stats.resize(limit);
+    return stats;
+}
+
+std::vector<RootChildStats> MCTS::RootChildren() const {
+    std::lock_guard<std::mutex> guard(treeSwapMutex);
+    return rootChildren(*tree, 0);
 }
 
-// 模拟函数：从某个节点开始随机走，结果始终从 aiPlayer 视角来评估
-double MCTS::simulate(AmazonBoard tempBoard, int currentPlayer, int aiPlayer) {
-    // 设置最大模拟步数，防止死循环
-    const int maxSteps = 20;
+void MCTS::collectStats(SearchStats& stats, int topMoves) const {
+    counters.fill(stats);
+    stats.solved = solvedByEndgame.load(std::memory_order_relaxed);
+    stats.prunes = pruneCount.load(std::memory_order_relaxed) - prunesAtStart.load(std::memory_order_relaxed);
+    // 根并行时这里只看得到 0 号线程的树
+    std::lock_guard<std::mutex> guard(treeSwapMutex);
+    stats.treeNodes = tree->nodeCount();
+    if (topMoves > 0) stats.topMoves = rootChildren(*tree, static_cast<size_t>(topMoves));
+}
 
-    static thread_local std::mt19937 rng(std::random_device{}());
+AmazonMove MCTS::search(const AmazonBoard& currentBoard, int aiPlayer, const SearchLimits& limits) {
+    counters.reset();
+    prunesAtStart.store(pruneCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    solvedByEndgame = false;
+    // 双方已经分开：谁赢只是数步数的问题，求解器算得出来就直接按它走
+    if (config.endgameSolver) {
+        endgame.setNodeBudget(config.endgameNodeBudget);
+        endgame.setMemoLimit(EndgameSolver::MemoEntriesForMB(config.endgameMemoryMB));
+        AmazonMove m;
+        if (endgame.bestMove(currentBoard, aiPlayer, m)) {
+            solvedByEndgame = true;
+            return m;
+        }
+    }
 
-    for (int step = 0; step < maxSteps; ++step) {
-        std::vector<AmazonMove> moves = getAllLegalMoves(tempBoard, currentPlayer);
+    int iterations = limits.iterations > 0 ? limits.iterations : std::numeric_limits<int>::max();
 
-        // 没有合法走法：当前玩家输
-        if (moves.empty()) {
-            // 如果当前没法走的是 AI，自然是 0 分；反之是 1 分
-            return (currentPlayer == aiPlayer) ? 0.0 : 1.0;
+    WorkerPool& pool = workers();
+    int threads = pool.size();
+    // 给了种子就每次搜索从头按种子来；整个搜索里每个线程只播种一次，回收节点后接着原来的随机序列
+    if (config.seed != 0) {
+        seededRngs.resize(threads);
+        for (int id = 0; id < threads; id++) seededRngs[id].seed(config.seed + static_cast<uint32_t>(id));
+    }
+    size_t ttSize = static_cast<size_t>(std::max(0, config.transpositionTableMB));
+    if (tt.sizeMegabytes() != ttSize) {
+        tt.resize(ttSize);
+    }
+
+    bool rootParallel = config.parallelMode == PARALLEL_ROOT && threads > 1;
+    if (rootParallel) {
+        while (static_cast<int>(rootTrees.size()) < threads - 1) {
+            rootTrees.emplace_back(new SearchTree);
         }
+    }
+    applyMemoryBudget(rootParallel ? threads : 1);
 
-        std::uniform_int_distribution<int> dist(0, static_cast<int>(moves.size()) - 1);
-        AmazonMove m = moves[dist(rng)];
+    if (rootParallel) {
+        // 根并行：每个线程一棵树，各分到一份迭代次数
+        pool.run([&](int id) {
+            SearchTree& t = (id == 0) ? *tree : *rootTrees[id - 1];
+            if (id != 0) {
+                t.resetRoot(aiPlayer);
+            }
+            std::atomic<int> budget(iterations / threads + (id < iterations % threads ? 1 : 0));
+            runIterations(t, currentBoard, aiPlayer, budget, 1, id);
+        });
 
-        // 执行动作
-        tempBoard.grid[m.qy1][m.qx1] = EMPTY;
-        tempBoard.grid[m.qy2][m.qx2] = currentPlayer;
-        tempBoard.grid[m.ay][m.ax] = ARROW;
+        // 按动作合并所有树根节点孩子的访问数
+        std::unordered_map<uint32_t, uint32_t> merged; // 键是 PackedMove::bits
+        AmazonMove bestMove = rootFallback;
+        uint32_t bestVisits = 0;
+        for (int id = 0; id < threads; id++) {
+            const SearchTree& t = (id == 0) ? *tree : *rootTrees[id - 1];
+            const MCTSNode& r = t.node(t.root);
+            int n = r.numChildren();
+            NodeIndex c = r.firstChild;
+            for (int k = 0; k < n; k++) {
+                const MCTSNode& child = t.node(c);
+                uint32_t total = (merged[child.move.bits] += child.visits.load(std::memory_order_relaxed));
+                if (total > bestVisits) {
+                    bestVisits = total;
+                    bestMove = child.move.unpack();
+                }
+                if (k + 1 < n) c = child.nextSibling;
+            }
+        }
+        return bestMove;
+    }
 
-        // 轮到另外一方
-        currentPlayer = 3 - currentPlayer;
+    // 树并行（单线程也走这里）：所有线程从同一个迭代计数里领任务。
+    // 树长满时线程全部退出，回收一次节点再接着搜，直到预算用完或到时
+    std::atomic<int> budget(iterations);
+    int virtualLoss = std::max(1, config.virtualLoss);
+    while (true) {
+        pool.run([&](int id) {
+            runIterations(*tree, currentBoard, aiPlayer, budget, virtualLoss, id, config.recycleNodes);
+        });
+        if (!config.recycleNodes || !tree->full() || timeUp() || budget.load(std::memory_order_relaxed) <= 0) {
+            break;
+        }
+        pruneTree();
     }
+    return mostVisitedChild(*tree);
+}
 
-    // 没有走到终局，用行动力（合法步数）来估分
-    int myMoves = static_cast<int>(getAllLegalMoves(tempBoard, aiPlayer).size());
-    int oppMoves = static_cast<int>(getAllLegalMoves(tempBoard, 3 - aiPlayer).size());
-    int total = myMoves + oppMoves;
-    if (total == 0) {
-        return 0.5; // 双方都动不了，当成平局
+void MCTS::applyMemoryBudget(int numTrees) {
+    size_t perTree = 0;
+    if (config.treeMemoryMB > 0) {
+        size_t totalNodes = (static_cast<size_t>(config.treeMemoryMB) << 20) / sizeof(MCTSNode);
+        perTree = std::max<size_t>(1, totalNodes / (numTrees + 1));
+        // 预算比一个分块还小时也给一块，否则树根都放不下
+        perTree = std::max<size_t>(perTree, SearchTree::kChunkSize);
+    }
+    if (tree->root != kNullNode && perTree != 0 && tree->nodeCount() > perTree) {
+        spareTree->setCapacity(perTree);
+        pruneTree();
+    }
+    tree->setCapacity(perTree);
+    spareTree->setCapacity(perTree);
+    for (size_t i = 0; i < rootTrees.size(); i++) {
+        // 这次用不上的根并行树清空
+        if (static_cast<int>(i) + 1 >= numTrees) rootTrees[i]->clear();
+        rootTrees[i]->setCapacity(perTree);
     }
-    return static_cast<double>(myMoves) / static_cast<double>(total);
 }
 
-// 我需要一个评估函数，来找到对bot最有利的走法。“最有利”的衡量是合法步数之比。
-double MCTS::evaluateBoard(const AmazonBoard& mBoard, int mPlayer){
-    auto myMoves = static_cast<int>(getAllLegalMoves(mBoard, mPlayer).size());
-    auto enemyMoves = static_cast<int>(getAllLegalMoves(mBoard, 3 - mPlayer).size());
+void MCTS::pruneTree() {
+    // 访问数够多的节点保留全部孩子，其余节点截断成叶子；留出一半容量给接下来的展开
+    uint32_t minVisits = tree->pruneThreshold(spareTree->capacity() / 2);
+    spareTree->copySubtree(*tree, tree->root, minVisits);
+    {
+        std::lock_guard<std::mutex> guard(treeSwapMutex);
+        std::swap(tree, spareTree);
+        spareTree->clear();
+    }
+    pruneCount.fetch_add(1, std::memory_order_relaxed);
+}
 
-    int total = myMoves + enemyMoves;
-    if (total == 0) {
-        return 0.5; // 双方都被封死
+size_t MCTS::MemoryUsage() const {
+    size_t bytes = tree->memoryBytes() + spareTree->memoryBytes() + tt.memoryBytes() + endgame.memoryBytes();
+    for (const auto& t : rootTrees) {
+        bytes += t->memoryBytes();
     }
-    return static_cast<double>(myMoves) / static_cast<double>(total);
+    return bytes;
 }
 
-// 获得一个行动方式的数组，包含该状态下所有合法的行动方式
-std::vector<AmazonMove> MCTS::getAllLegalMoves(const AmazonBoard& mBoard, int player){
-    std::vector<AmazonMove> allLegalMoves;
-    int dx[8]={0,0,1,1,1,-1,-1,-1};
-    int dy[8]={1,-1,1,-1,0,0,1,-1};
-    //方向数组
-    
-    //找到自己的棋子
-    for(int i=0;i<8;i++){
-        for(int j=0;j<8;j++){
-            if(mBoard.grid[j][i] != player){
-                continue;
+// 一批里的一个叶子：从树根到它经过的节点和对应局面的棋盘哈希，回溯时用
+struct PendingLeaf {
+    NodeIndex path[kMaxTreeDepth + 1];
+    uint64_t pathHash[kMaxTreeDepth + 1];
+    int depth;
+};
+
+void MCTS::runIterations(SearchTree& t, const AmazonBoard& rootBoard, int aiPlayer, std::atomic<int>& budget, int virtualLoss,
+                         int threadId, bool stopWhenFull) {
+    // 使用一个固定的随机数引擎，比 rand() 更稳定；每个线程一个。给了种子时用 search() 播好种的那个
+    static thread_local std::mt19937 threadRng(std::random_device{}());
+    std::mt19937& rng = config.seed != 0 ? seededRngs[threadId] : threadRng;
+
+    // 模拟批和叶子路径每个线程一份，跨搜索复用
+    static thread_local RolloutBatch batch;
+    static thread_local std::vector<PendingLeaf> leaves(RolloutBatch::kMaxSize);
+    int batchSize = std::max(1, std::min(config.rolloutBatch, RolloutBatch::kMaxSize));
+    RolloutSettings rollout;
+    rollout.depth = config.rolloutDepth;
+    rollout.sampling = config.rolloutSampling;
+    rollout.leafEvaluation = config.leafEvaluation;
+    rollout.endgameSolver = config.endgameSolver;
+    rollout.endgameMemoEntries = EndgameSolver::MemoEntriesForMB(config.endgameMemoryMB) / 4;
+
+    const TranspositionTable* shared = tt.enabled() ? &tt : nullptr;
+    bool widening = config.selection != SELECT_UCB1;
+    bool puct = config.selection == SELECT_PUCT;
+    // 计数先记在本线程，每 64 次迭代并进共享计数一次，界面上看到的数字最多落后这么多
+    SearchCounters local;
+
+    bool more = true;
+    while (more) {
+        batch.clear();
+        while (batch.size() < batchSize) {
+            if (timeUp() || (stopWhenFull && t.full()) || budget.fetch_sub(1, std::memory_order_relaxed) <= 0) {
+                more = false;
+                break;
             }
-            else{
-                // move queen
-                for(int direction=0;direction<8;direction++){
-                    for(int distance=1;distance<8;distance++){
-                        int target_x=i+distance*dx[direction];
-                        int target_y=j+distance*dy[direction];
-                        if(target_x<0||target_x>7||target_y<0||target_y>7){
-                            break;
-                        }
-                        if(mBoard.IsPathClear(i,j,target_x,target_y)){
-                            // 更新棋盘，shoot arrow
-                            AmazonBoard afterMove_board=mBoard;
-                            afterMove_board.SetPiece(i,j,0);
-                            afterMove_board.SetPiece(target_x,target_y,player);
-
-                            afterMove_board.SetPiece(target_x,target_y,EMPTY);//临时把女王看成空，方便射箭
-
-                            for(int direction_arrow=0;direction_arrow<8;direction_arrow++){
-                                for(int distance_arrow=1;distance_arrow<8;distance_arrow++){
-                                    int target_arrow_x=target_x+distance_arrow*dx[direction_arrow];
-                                    int target_arrow_y=target_y+distance_arrow*dy[direction_arrow];
-                                    if(target_arrow_x<0||target_arrow_x>7||target_arrow_y<0||target_arrow_y>7){
-                                        break;
-                                    }
-                                    if(afterMove_board.IsPathClear(target_x,target_y,target_arrow_x,target_arrow_y)){
-                                        allLegalMoves.push_back({i,j,target_x,target_y,target_arrow_x,target_arrow_y});
-                                    }
-                                }
-                            }
+            PendingLeaf& leaf = leaves[batch.size()];
+            NodeIndex* path = leaf.path;
+            uint64_t* pathHash = leaf.pathHash;
+            NodeIndex node = t.root;
+            int depth = 0;
+            AmazonBoard board = rootBoard; // 沿路径重新走出当前节点的棋盘
+            pathHash[depth] = board.hash;
+            path[depth++] = node;
+            t.node(node).visits.fetch_add(virtualLoss, std::memory_order_relaxed);
 
-                            afterMove_board.SetPiece(target_x,target_y,player);
+            // 1. Selection：已经完全展开的节点沿着 UCB1 往下走，直到遇到还有未展开动作的节点或终局
+            while (true) {
+                MCTSNode& n = t.node(node);
+                if (n.legalMoves() < 0) {
+                    SEARCH_TIMER(local, PHASE_MOVEGEN);
+                    n.lock();
+                    if (n.numLegalMoves.load(std::memory_order_relaxed) < 0) {
+                        initUntried(n, board, rng);
+                    }
+                    n.unlock();
+                }
+                // 如果这个节点已经无子可走，相当于终局，直接停止选择
+                if (n.legalMoves() == 0) {
+                    break;
+                }
 
+                // 2. Expansion：只建出下一个未尝试的孩子，然后从它开始模拟。
+                // 渐进展开时孩子数受访问数限制，按启发分从高到低依次展开
+                int allowed = n.legalMoves();
+                if (widening) {
+                    float visits = static_cast<float>(n.visits.load(std::memory_order_relaxed));
+                    allowed = std::min(allowed, std::max(1, static_cast<int>(config.wideningBase * std::pow(visits, config.wideningExponent))));
+                }
+                if (n.numChildren() < allowed) {
+                    AmazonMove m;
+                    NodeIndex child = kNullNode;
+                    n.lock();
+                    if (n.numChildren() < allowed) {
+                        float prior = 0.0f;
+                        {
+                            SEARCH_TIMER(local, PHASE_MOVEGEN);
+                            if (widening) {
+                                RankedMove(board, n.playerToMove, n.numChildren(), m, config.priorTemperature, &prior);
+                            } else {
+                                MoveAtIndex(board, n.playerToMove, n.nextUntriedIndex(), m);
+                            }
                         }
+                        SEARCH_TIMER(local, PHASE_EXPAND);
+                        child = widening ? t.addChild(node, m, MCTSNode::encodePrior(prior)) : t.addChild(node, m);
+                    }
+                    n.unlock();
+                    if (child != kNullNode) {
+                        board.MakeMove(m, n.playerToMove);
+                        t.node(child).visits.fetch_add(virtualLoss, std::memory_order_relaxed);
+                        pathHash[depth] = board.hash;
+                        path[depth++] = child;
+                        node = child;
+                        break;
+                    }
+                    // 别的线程刚好展开了最后一个孩子，或者节点池用完了：退回到在已有孩子里选
+                    if (n.numChildren() == 0) {
+                        break;
+                    }
+                }
+
+                SEARCH_TIMER(local, PHASE_SELECT);
+                int player = n.playerToMove;
+                node = t.selectChild(node, puct ? config.puctConstant : config.explorationConstant, puct, shared, board.hash);
+                t.node(node).visits.fetch_add(virtualLoss, std::memory_order_relaxed);
+                board.MakeMove(t.node(node).move, player);
+                pathHash[depth] = board.hash;
+                path[depth++] = node;
+            }
+
+            // 叶子先攒进这一批，它和路径上的节点都挂着虚拟损失，同一批后面的叶子会尽量绕开这条路
+            leaf.depth = depth;
+            batch.add(board, t.node(node).playerToMove);
+        }
+        if (batch.size() == 0) break;
+
+        // 3. Simulation：这一批叶子一起随机模拟，对 AI 视角打分
+        {
+            SEARCH_TIMER(local, PHASE_SIMULATE);
+            batch.run(rollout, aiPlayer, rng);
+        }
+
+        // 4. Backpropagation：逐个叶子沿路径回溯。每个节点记的是走出它的那一方的得分，
+        // 这样父节点在 selectChild 里取最大值时，双方都在为自己选最好的动作。
+        // 访问数在下降时已经加过（虚拟损失），这里只补上得分，多记的虚拟访问扣回去；
+        // 置换表里对应局面的访问数和得分也一起加上
+        SEARCH_TIMER(local, PHASE_BACKPROP);
+        for (int i = 0; i < batch.size(); i++) {
+            const PendingLeaf& leaf = leaves[i];
+            double result = batch.result(i);
+            for (int d = leaf.depth - 1; d >= 0; d--) {
+                MCTSNode& back = t.node(leaf.path[d]);
+                double score = (back.playerToMove == aiPlayer) ? 1.0 - result : result;
+                back.addWins(score);
+                if (shared) {
+                    uint32_t sharedVisits = tt.update(leaf.pathHash[d] ^ kZobrist.side[back.playerToMove], score);
+                    if (sharedVisits > back.visits.load(std::memory_order_relaxed)) {
+                        back.transposed.store(1, std::memory_order_relaxed);
                     }
                 }
+                if (virtualLoss > 1) {
+                    back.visits.fetch_sub(virtualLoss - 1, std::memory_order_relaxed);
+                }
             }
+
+            local.iterations++;
+            local.maxDepth = std::max(local.maxDepth, leaf.depth - 1);
+            if ((local.iterations & 63) == 0) counters.merge(local);
         }
     }
-    return allLegalMoves;
-}
\ No newline at end of file
+    counters.merge(local);
+}
+
+void MCTS::AdvanceRoot(const AmazonMove& m) {
+    StopSearch();
+    if (tree->root == kNullNode) return;
+
+    int player = tree->node(tree->root).playerToMove;
+    NodeIndex child = tree->findChild(tree->root, m);
+    if (child == kNullNode) {
+        tree->clear();
+        return;
+    }
+    spareTree->copySubtree(*tree, child);
+    std::swap(tree, spareTree);
+    spareTree->clear();
+    treeBoard.MakeMove(m, player);
+}
+
+void MCTS::ResetTree() {
+    StopSearch();
+    tree->clear();
+}
+
+// 我需要一个评估函数，来找到对bot最有利的走法。
+double MCTS::evaluateBoard(const AmazonBoard& mBoard, int mPlayer){
+    if (config.leafEvaluation == EVAL_TERRITORY) {
+        return EvaluateTerritory(mBoard, mPlayer, mPlayer);
+    }
+    return EvaluateMobility(mBoard, mPlayer);
+}
+
+// 获得一个行动方式的数组，包含该状态下所有合法的行动方式
+std::vector<AmazonMove> MCTS::getAllLegalMoves(const AmazonBoard& mBoard, int player){
+    static thread_local MoveList moves;
+    GenerateMoves(mBoard, player, moves);
+    return std::vector<AmazonMove>(moves.begin(), moves.end());
+}
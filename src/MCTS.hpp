@@ -2,57 +2,171 @@
 #define MCTS_HPP
 
 #include "Board.hpp"
+#include "Endgame.hpp"
+#include "Evaluation.hpp"
+#include "MoveGen.hpp"
+#include "RolloutBatch.hpp"
+#include "SearchEngine.hpp"
+#include "SearchTree.hpp"
+#include "TranspositionTable.hpp"
+#include "WorkerPool.hpp"
+#include <atomic>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <cmath>
 
-// 定义一个完整的亚马逊棋动作
-struct AmazonMove {
-    int qx1, qy1, qx2, qy2; // 移动女王
-    int ax, ay;             // 射箭
+// 多线程搜索的方式
+enum ParallelMode {
+    // 所有线程共用一棵树，统计量是原子量；下降时先给路过的节点加"虚拟损失"，让别的线程暂时绕开这条路
+    PARALLEL_TREE = 0,
+    // 每个线程各搜一棵独立的树，最后按动作把根节点孩子的访问数和得分加起来
+    PARALLEL_ROOT = 1
 };
 
-class MCTSNode {
-public:
-    AmazonBoard board;
-    AmazonMove move; // 到达此状态的动作
-    MCTSNode* parent;
-    std::vector<std::unique_ptr<MCTSNode>> children;
-    
-    int visits = 0;
-    double wins = 0.0f;
-    int playerToMove; // 谁在该节点下棋
-
-    MCTSNode(AmazonBoard b, int p, MCTSNode* prnt = nullptr) 
-        : board(b), playerToMove(p), parent(prnt) {}
-
-    // UCB1 公式选择最佳子节点
-    MCTSNode* selectChild() {
-        MCTSNode* best = nullptr;
-        float bestUCB = -1e9;
-        for (auto& child : children) {
-            float ucb = (child->wins / (child->visits + 1e-6f)) + 
-                        2.0f * std::sqrt(std::log((float)visits + 1.0f) / (child->visits + 1e-6f));
-            if (ucb > bestUCB) {
-                bestUCB = ucb;
-                best = child.get();
-            }
-        }
-        return best;
-    }
+// 选择阶段怎么在孩子里挑
+enum SelectionPolicy {
+    // 孩子按随机顺序全部展开，在所有孩子里用 UCB1 挑
+    SELECT_UCB1 = 0,
+    // 孩子按启发分从高到低展开，允许的孩子数随访问数增长（渐进展开），在已展开的孩子里用 UCB1 挑
+    SELECT_WIDENING = 1,
+    // 同上，但用 PUCT 挑：启发分换算成先验概率，先验高的孩子多探索
+    SELECT_PUCT = 2
+};
+
+// 搜索参数，调参和对比不同配置时只改这里
+struct MCTSConfig {
+    // 模拟阶段随机抽动作的方式，默认严格均匀；SAMPLE_STAGED 更快但分布只是近似均匀
+    RolloutSampling rolloutSampling = SAMPLE_UNIFORM;
+    // 模拟最多走几步就截断并评估，0 表示不模拟、直接评估展开出来的节点
+    int rolloutDepth = 4;
+    // 截断后给局面打分的方式
+    LeafEvaluation leafEvaluation = EVAL_TERRITORY;
+    // 每个线程连续选出几个叶子（都挂着虚拟损失）再一起模拟、一起回溯，最多 RolloutBatch::kMaxSize。
+    // 批大时领地评估的填充能把 SIMD 的 4 道填满，但同一批里后选的叶子看不到前面叶子的结果；
+    // 模拟的大头是抽随机动作，它在单个局面内部就已经向量化了，所以默认 1（和逐个模拟完全一样）
+    int rolloutBatch = 1;
+    SelectionPolicy selection = SELECT_PUCT;
+    // UCB1 的探索系数
+    float explorationConstant = 2.0f;
+    // PUCT 的探索系数
+    float puctConstant = 4.0f;
+    // 渐进展开：访问 n 次的节点最多展开 wideningBase * n^wideningExponent 个孩子
+    float wideningBase = 2.0f;
+    float wideningExponent = 0.5f;
+    // 启发分换算先验概率时的温度，越大先验越平均
+    float priorTemperature = 4.0f;
+    // 搜索线程数，0 表示用上所有硬件线程
+    int numThreads = 1;
+    ParallelMode parallelMode = PARALLEL_TREE;
+    // 树并行时每个线程下降经过一个节点就先记多少次（没有得分的）访问，回溯时再扣回来
+    int virtualLoss = 1;
+    // 置换表大小（MB），0 表示不用。不同走子顺序到达的同一局面共享访问数和得分
+    int transpositionTableMB = 64;
+    // 棋盘被箭分成双方互不相通的区域后改用精确的残局求解，不再做 MCTS；模拟走到这种局面时也直接数步数判胜负
+    bool endgameSolver = true;
+    // 残局求解每次最多搜多少个局面，超出时退回 MCTS
+    int endgameNodeBudget = 2000000;
+    // 残局求解器记忆表最多占多少内存（MB），0 表示不限；跨回合保留、满了就清空。每个搜索线程模拟用的求解器另外最多占它的四分之一。
+    // 树和置换表的内存预算不包括它，内存紧张时三者要一起算
+    int endgameMemoryMB = 192;
+    // 搜索树最多占多少内存（MB），推进树根、整理树时用的备用树和根并行的各棵树都算在内；0 表示不限（最多 6400 万个节点一棵树）。
+    // 置换表另算，见 transpositionTableMB
+    int treeMemoryMB = 1024;
+    // 树长满时怎么办：true 时暂停搜索，丢掉访问少的节点下面的子树（节点本身和统计量保留）再接着搜；
+    // false 时不再展开新节点，只在已有的树上继续选择、模拟、更新统计。根并行时总是后者
+    bool recycleNodes = true;
+    // 随机数种子，0 表示每个线程用 random_device 随机初始化。
+    // 非 0 时每次搜索第 i 个线程都从 seed + i 开始，单线程、按迭代次数搜索时结果完全可以复现（基准测试用）
+    uint32_t seed = 0;
 };
 
-class MCTS {
+class MCTS : public SearchEngine {
 public:
+    MCTSConfig config;
+
+    MCTS();
+    ~MCTS();
+
     // 找出当前局面所有合法动作（这是最难的部分）
+    // 会分配一个新数组，只适合界面这类冷路径；搜索内部直接用 GenerateMoves 写进 MoveList
     std::vector<AmazonMove> getAllLegalMoves(const AmazonBoard& mBoard, int player);
     // AI 思考的主函数，返回最佳动作
+    // 如果 currentBoard 正好是上一次留下的树根局面，就在旧树上继续搜索，iterations 是新增的迭代次数
+    using SearchEngine::GetBestMove;
     AmazonMove GetBestMove(AmazonBoard currentBoard, int aiPlayer, int iterations = 5000);
+
+    // 树根推进到实际走的动作 m 对应的孩子，其余分支丢弃；会先停掉后台思考。
+    // 对应孩子还没展开时整棵树作废，下一次 GetBestMove 从头搜
+    void AdvanceRoot(const AmazonMove& m) override;
+    // 丢弃整棵树
+    void ResetTree() override;
+    const char* Name() const override { return "MCTS"; }
+
+    // 搜索树、置换表和残局记忆表当前实际占用的内存（字节），包括备用树和根并行的各棵树（不含模拟用的求解器）
+    size_t MemoryUsage() const;
+    // 主搜索树里的节点数
+    size_t TreeNodeCount() const { return tree->nodeCount(); }
+    // 开局以来因为树长满而回收过几次子树
+    int PruneCount() const { return pruneCount.load(std::memory_order_relaxed); }
+    // 树根各个孩子的访问数和胜率，按访问数从多到少；搜索进行中也可以调用
+    std::vector<RootChildStats> RootChildren() const;
+
+    // 按 config.leafEvaluation 给局面打分，mPlayer 视角、假定轮到 mPlayer 走
     double evaluateBoard(const AmazonBoard& mBoard, int mPlayer);
     
 private:
-    // 模拟随机下棋直到结束
-    double simulate(AmazonBoard tempBoard, int currentPlayer, int aiPlayer);
+    // 搜索树节点池，局面对不上时 O(1) 清空，内存留给下一次搜索
+    std::unique_ptr<SearchTree> tree;
+    // 推进树根时把保留的子树复制到这里再和 tree 交换，复制完的新树里孩子块都是紧凑的
+    std::unique_ptr<SearchTree> spareTree;
+    // tree 的根节点对应的局面
+    AmazonBoard treeBoard;
+    // tree 里的孩子是不是按启发分顺序展开的；和 config.selection 对不上时树要重建，两种展开顺序不能混用
+    bool treeRanked = false;
+    // 根并行时 1 号及以后的线程各自用的树（0 号线程用 tree）
+    std::vector<std::unique_ptr<SearchTree>> rootTrees;
+    // 按局面共享的统计，所有树（包括根并行的各棵树）共用；局面的价值和怎么走到它无关，所以换回合、重建树时都保留
+    TranspositionTable tt;
+    // 残局求解器，记忆表跨回合保留（残局局面一步步往下走，之前算过的子局面大多还用得上）
+    EndgameSolver endgame{0};
+    // 常驻的搜索线程，线程数变化时重建
+    std::unique_ptr<WorkerPool> pool;
+    // 搜索中回收子树要交换 tree 和 spareTree，和 currentBest 读 tree 互斥
+    mutable std::mutex treeSwapMutex;
+    std::atomic<int> pruneCount{0};
+    // 这次搜索的统计：各线程的计数、开始时的回收次数、是不是残局求解器直接给的动作
+    SharedSearchCounters counters;
+    std::atomic<int> prunesAtStart{0};
+    std::atomic<bool> solvedByEndgame{false};
+    // config.seed 非 0 时各线程的随机数引擎（下标是线程编号），每次搜索开始时播种
+    std::vector<std::mt19937> seededRngs;
+
+    WorkerPool& workers();
+
+    // 准备好树根（能复用就复用），返回根局面是否还有合法动作。必须在搜索线程外调用
+    bool prepareRoot(const AmazonBoard& currentBoard, int aiPlayer) override;
+    // 在已经准备好的树根上按预算搜索，返回最佳动作
+    AmazonMove search(const AmazonBoard& currentBoard, int aiPlayer, const SearchLimits& limits) override;
+    AmazonMove currentBest() const override {
+        std::lock_guard<std::mutex> guard(treeSwapMutex);
+        return mostVisitedChild(*tree);
+    }
+    // 访问次数最多的根节点孩子
+    AmazonMove mostVisitedChild(const SearchTree& t) const;
+    // t 的根孩子统计，按访问数从多到少，最多 limit 个（0 表示全部）
+    static std::vector<RootChildStats> rootChildren(const SearchTree& t, size_t limit);
+    void collectStats(SearchStats& stats, int topMoves) const override;
+
+    // 按 config.treeMemoryMB 给 numTrees 棵搜索树（加一棵备用树）分配容量，已经超出新容量的树先回收
+    void applyMemoryBudget(int numTrees);
+    // 回收 tree 里访问少的子树，把它压到容量的一半以内。不能和搜索线程同时调用
+    void pruneTree();
+
+    // 一个线程的搜索循环：在 t 上反复做选择/展开/模拟/回溯，直到 budget 用完、到时或被停止。树并行时多个线程共用同一个 t。
+    // threadId 是线程在线程池里的编号（决定固定种子时的随机序列），stopWhenFull 为 true 时树长满就退出，好让调用方回收节点
+    void runIterations(SearchTree& t, const AmazonBoard& rootBoard, int aiPlayer, std::atomic<int>& budget, int virtualLoss,
+                       int threadId, bool stopWhenFull = false);
 };
 
 #endif
\ No newline at end of file
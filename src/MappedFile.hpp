@@ -0,0 +1,33 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+// 只读地把整个文件映射进内存（POSIX 用 mmap，Windows 用 CreateFileMapping），开局库和对局库都用它。
+// 映射期间文件内容直接当内存读，不解析、不复制，操作系统按需把页读进来
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 映射 path，失败（不存在、空文件、映射失败）时返回 false。之前的映射会先关掉
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return view != nullptr; }
+    const char* data() const { return static_cast<const char*>(view); }
+    size_t size() const { return length; }
+
+private:
+    void* view = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mapHandle = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "MoveGen.hpp"
+#include <cmath>
+
+int GenerateMoves(const AmazonBoard& board, int player, MoveList& list) {
+    list.clear();
+    ForEachMove(board, player, [&list](const AmazonMove& m) { list.push(m); });
+    return list.count;
+}
+
+int CountMoves(const AmazonBoard& board, int player) {
+    int count = 0;
+    Bitboard queens = board.Queens(player);
+    while (queens) {
+        int from = PopLowestBit(queens);
+        Bitboard targets = QueenAttacks(from, board.occupied);
+        Bitboard occupiedAfterLeave = board.occupied & ~SquareBit(from);
+        while (targets) {
+            int to = PopLowestBit(targets);
+            count += PopCount(QueenAttacks(to, occupiedAfterLeave));
+        }
+    }
+    return count;
+}
+
+bool MoveAtIndex(const AmazonBoard& board, int player, int index, AmazonMove& out) {
+    Bitboard queens = board.Queens(player);
+    while (queens) {
+        int from = PopLowestBit(queens);
+        Bitboard targets = QueenAttacks(from, board.occupied);
+        Bitboard occupiedAfterLeave = board.occupied & ~SquareBit(from);
+        while (targets) {
+            int to = PopLowestBit(targets);
+            Bitboard arrowTargets = QueenAttacks(to, occupiedAfterLeave);
+            int n = PopCount(arrowTargets);
+            if (index < n) {
+                int arrow = NthBit(arrowTargets, index);
+                out = AmazonMove{SquareX(from), SquareY(from), SquareX(to), SquareY(to), SquareX(arrow), SquareY(arrow)};
+                return true;
+            }
+            index -= n;
+        }
+    }
+    return false;
+}
+
+// 在 [0, n) 里均匀取一个整数
+static int RandomIndex(std::mt19937& rng, int n) {
+    return std::uniform_int_distribution<int>(0, n - 1)(rng);
+}
+
+bool SampleRandomMove(const AmazonBoard& board, int player, std::mt19937& rng, AmazonMove& out,
+                      RolloutSampling mode) {
+    Bitboard queens = board.Queens(player);
+
+    if (mode == SAMPLE_STAGED) {
+        // 能动的女王 = 身边有空格的女王，它们至少有一个落点，而每个落点至少能把箭射回原位
+        Bitboard movable = 0;
+        Bitboard rest = queens;
+        while (rest) {
+            int sq = PopLowestBit(rest);
+            if (KingAttacks(SquareBit(sq)) & ~board.occupied) movable |= SquareBit(sq);
+        }
+        if (!movable) return false;
+
+        int from = NthBit(movable, RandomIndex(rng, PopCount(movable)));
+        Bitboard targets = QueenAttacks(from, board.occupied);
+        int to = NthBit(targets, RandomIndex(rng, PopCount(targets)));
+        Bitboard arrowTargets = QueenAttacks(to, board.occupied & ~SquareBit(from));
+        int arrow = NthBit(arrowTargets, RandomIndex(rng, PopCount(arrowTargets)));
+        out = AmazonMove{SquareX(from), SquareY(from), SquareX(to), SquareY(to), SquareX(arrow), SquareY(arrow)};
+        return true;
+    }
+
+    // 每个 (女王, 落点) 记下它的射箭集合，权重就是集合大小；最多 4 × 27 项
+    int froms[4 * 27];
+    int tos[4 * 27];
+    Bitboard arrowSets[4 * 27];
+    int n = 0;
+    int total = 0;
+    while (queens) {
+        int from = PopLowestBit(queens);
+        Bitboard targets = QueenAttacks(from, board.occupied);
+        Bitboard occupiedAfterLeave = board.occupied & ~SquareBit(from);
+        while (targets) {
+            int to = PopLowestBit(targets);
+            froms[n] = from;
+            tos[n] = to;
+            arrowSets[n] = QueenAttacks(to, occupiedAfterLeave);
+            total += PopCount(arrowSets[n]);
+            n++;
+        }
+    }
+    if (total == 0) return false;
+
+    int r = RandomIndex(rng, total);
+    int i = 0;
+    while (r >= PopCount(arrowSets[i])) {
+        r -= PopCount(arrowSets[i]);
+        i++;
+    }
+    int arrow = NthBit(arrowSets[i], r);
+    out = AmazonMove{SquareX(froms[i]), SquareY(froms[i]), SquareX(tos[i]), SquareY(tos[i]), SquareX(arrow), SquareY(arrow)};
+    return true;
+}
+
+// 把 (女王, 落点) 的射箭集合按启发分分成三档，交给 visit(from, to, 分数, 这一档的射箭集合)。
+// 同一个 (女王, 落点) 下依次给出高、中、低三档
+template <typename Visitor>
+static void ForEachScoredArrowSet(const AmazonBoard& board, int player, Visitor&& visit) {
+    Bitboard nearOpponent = KingAttacks(board.Queens(3 - player));
+    Bitboard queens = board.Queens(player);
+    while (queens) {
+        int from = PopLowestBit(queens);
+        Bitboard targets = QueenAttacks(from, board.occupied);
+        Bitboard occupiedAfterLeave = board.occupied & ~SquareBit(from);
+        while (targets) {
+            int to = PopLowestBit(targets);
+            Bitboard arrows = QueenAttacks(to, occupiedAfterLeave);
+            int mobility = PopCount(arrows);
+            Bitboard nearSelf = KingAttacks(SquareBit(to));
+            Bitboard high = arrows & nearOpponent & ~nearSelf;
+            Bitboard low = arrows & nearSelf & ~nearOpponent;
+            visit(from, to, mobility + 8, high);
+            visit(from, to, mobility + 4, arrows & ~high & ~low);
+            visit(from, to, mobility, low);
+        }
+    }
+}
+
+bool RankedMove(const AmazonBoard& board, int player, int rank, AmazonMove& out, float temperature, float* prior) {
+    // 第一遍：每个分数档有多少个动作
+    int counts[kMaxMoveHeuristic + 1] = {0};
+    ForEachScoredArrowSet(board, player, [&counts](int, int, int score, Bitboard arrows) {
+        counts[score] += PopCount(arrows);
+    });
+
+    // 从高分档往下数，找到第 rank 个动作所在的档和它在档内的序号
+    int level = kMaxMoveHeuristic;
+    while (level >= 0 && rank >= counts[level]) {
+        rank -= counts[level];
+        level--;
+    }
+    if (level < 0) return false;
+
+    if (prior) {
+        // 以自己的档为基准做归一化，指数不会溢出
+        float sum = 0.0f;
+        for (int s = 0; s <= kMaxMoveHeuristic; s++) {
+            if (counts[s]) sum += counts[s] * std::exp((s - level) / temperature);
+        }
+        *prior = 1.0f / sum;
+    }
+
+    // 第二遍：按生成顺序在这一档里数到第 rank 个
+    bool found = false;
+    ForEachScoredArrowSet(board, player, [&](int from, int to, int score, Bitboard arrows) {
+        if (found || score != level) return;
+        int n = PopCount(arrows);
+        if (rank < n) {
+            int arrow = NthBit(arrows, rank);
+            out = AmazonMove{SquareX(from), SquareY(from), SquareX(to), SquareY(to), SquareX(arrow), SquareY(arrow)};
+            found = true;
+        } else {
+            rank -= n;
+        }
+    });
+    return found;
+}
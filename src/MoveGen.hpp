@@ -0,0 +1,99 @@
+#ifndef MOVEGEN_HPP
+#define MOVEGEN_HPP
+
+#include "Board.hpp"
+#include <random>
+
+// 8x8 棋盘上合法动作数的上界：4 个女王 × 最多 27 个落点 × 每个落点最多 27 个射箭位置
+const int kMaxMoves = 4 * 27 * 27;
+
+// 调用方持有的定长动作缓冲区，生成走法时不做任何堆分配
+struct MoveList {
+    AmazonMove moves[kMaxMoves];
+    int count = 0;
+
+    void clear() { count = 0; }
+    void push(const AmazonMove& m) { moves[count++] = m; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    AmazonMove& operator[](int i) { return moves[i]; }
+    const AmazonMove& operator[](int i) const { return moves[i]; }
+    AmazonMove* begin() { return moves; }
+    AmazonMove* end() { return moves + count; }
+    const AmazonMove* begin() const { return moves; }
+    const AmazonMove* end() const { return moves + count; }
+};
+
+// 逐个把合法动作交给 visit(const AmazonMove&)，不生成数组也不复制棋盘
+// 女王离开原位的情况直接在占用掩码上处理：射箭时用去掉原位的 occupied，落点本身不在射线里
+template <typename Visitor>
+inline void ForEachMove(const AmazonBoard& board, int player, Visitor&& visit) {
+    Bitboard queens = board.Queens(player);
+    while (queens) {
+        int from = PopLowestBit(queens);
+        Bitboard targets = QueenAttacks(from, board.occupied);
+        Bitboard occupiedAfterLeave = board.occupied & ~SquareBit(from);
+        while (targets) {
+            int to = PopLowestBit(targets);
+            Bitboard arrowTargets = QueenAttacks(to, occupiedAfterLeave);
+            while (arrowTargets) {
+                int arrow = PopLowestBit(arrowTargets);
+                visit(AmazonMove{SquareX(from), SquareY(from), SquareX(to), SquareY(to), SquareX(arrow), SquareY(arrow)});
+            }
+        }
+    }
+}
+
+// 把所有合法动作写进 list（先清空），返回动作数
+int GenerateMoves(const AmazonBoard& board, int player, MoveList& list);
+
+// 只数合法动作（女王移动 + 射箭）的个数，不生成动作：每个落点的射箭位置数就是一次 PopCount
+int CountMoves(const AmazonBoard& board, int player);
+
+// 取 ForEachMove 顺序下的第 index 个动作（0 <= index < CountMoves），只用计数不生成列表
+// 搜索树靠它按序号懒惰展开孩子：节点只记序号，不需要保存走法列表
+bool MoveAtIndex(const AmazonBoard& board, int player, int index, AmazonMove& out);
+
+// 是否还有任何合法动作。女王只要能走到某个落点，就一定能把箭射回刚离开的原位，
+// 所以等价于"某个女王身边有空格"，一次邻域位运算就够了
+inline bool HasAnyMove(const AmazonBoard& board, int player) {
+    return (KingAttacks(board.Queens(player)) & ~board.occupied) != 0;
+}
+
+// m 是不是 player 在这个局面的合法动作：坐标都在棋盘内，起点是自己的女王，女王和箭都沿直线走、中途和落点没有阻挡。
+// 置换表、开局库里取出的动作可能来自哈希碰撞的别的局面，外部输入的动作也要先过这一关
+inline bool IsLegalMove(const AmazonBoard& board, int player, const AmazonMove& m) {
+    const int coords[6] = {m.qx1, m.qy1, m.qx2, m.qy2, m.ax, m.ay};
+    for (int c : coords) {
+        if (c < 0 || c >= 8) return false;
+    }
+    int from = SquareOf(m.qx1, m.qy1), to = SquareOf(m.qx2, m.qy2), arrow = SquareOf(m.ax, m.ay);
+    if (!(board.Queens(player) & SquareBit(from))) return false;
+    if (!(QueenAttacks(from, board.occupied) & SquareBit(to))) return false;
+    // 箭从女王的新位置射出，女王原来的格子已经空出来了
+    return (QueenAttacks(to, board.occupied & ~SquareBit(from)) & SquareBit(arrow)) != 0;
+}
+
+// 随机抽一个合法动作的方式
+enum RolloutSampling {
+    // 严格均匀：先用计数内核算出每个 (女王, 落点) 的射箭数作为权重，按权重抽落点，再在射箭集合里均匀抽
+    SAMPLE_UNIFORM = 0,
+    // 近似均匀：依次均匀抽女王、落点、射箭位置，只需要两次射线查表，但射箭多的落点会被低估
+    SAMPLE_STAGED = 1
+};
+
+// 不枚举全部动作，直接抽取一个合法动作写进 out；没有合法动作时返回 false
+bool SampleRandomMove(const AmazonBoard& board, int player, std::mt19937& rng, AmazonMove& out,
+                      RolloutSampling mode = SAMPLE_UNIFORM);
+
+// 走法的廉价启发分，0..kMaxMoveHeuristic，越大越好：
+// 女王落点的行动力（也就是能射箭的格子数），箭落在对方女王身边 +4，落在自己新位置身边 -4
+const int kMaxMoveHeuristic = 27 + 8;
+
+// 按启发分从高到低排第 rank 个（从 0 开始）的动作，同分时按 ForEachMove 的顺序。
+// 只按分数档位做计数，不生成动作列表。prior 不为空时顺便给出这个动作的先验概率：
+// 所有动作按 exp(启发分 / temperature) 归一化后它占的比例。rank 超出动作数时返回 false
+bool RankedMove(const AmazonBoard& board, int player, int rank, AmazonMove& out,
+                float temperature = 4.0f, float* prior = nullptr);
+
+#endif
@@ -0,0 +1,162 @@
+#include "OpeningBook.hpp"
+#include "Zobrist.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// 对称变换表：squares[t][sq] 是 sq 经过第 t 种变换后的格子
+struct SymmetryTable {
+    uint8_t squares[kNumSymmetries][64];
+    int inverse[kNumSymmetries];
+
+    constexpr SymmetryTable() : squares(), inverse() {
+        for (int t = 0; t < kNumSymmetries; t++) {
+            for (int sq = 0; sq < 64; sq++) {
+                int x = sq & 7, y = sq >> 3;
+                // 低两位决定左右/上下翻，第三位决定是否先沿主对角线翻
+                if (t & 4) { int tmp = x; x = y; y = tmp; }
+                if (t & 1) x = 7 - x;
+                if (t & 2) y = 7 - y;
+                squares[t][sq] = static_cast<uint8_t>(y * 8 + x);
+            }
+        }
+        for (int t = 0; t < kNumSymmetries; t++) {
+            for (int u = 0; u < kNumSymmetries; u++) {
+                bool identity = true;
+                for (int sq = 0; sq < 64; sq++) {
+                    if (squares[u][squares[t][sq]] != sq) identity = false;
+                }
+                if (identity) inverse[t] = u;
+            }
+        }
+    }
+};
+
+static constexpr SymmetryTable kSymmetry{};
+
+int TransformSquare(int t, int sq) {
+    return kSymmetry.squares[t][sq];
+}
+
+int InverseSymmetry(int t) {
+    return kSymmetry.inverse[t];
+}
+
+AmazonMove TransformMove(int t, const AmazonMove& m) {
+    int from = TransformSquare(t, SquareOf(m.qx1, m.qy1));
+    int to = TransformSquare(t, SquareOf(m.qx2, m.qy2));
+    int arrow = TransformSquare(t, SquareOf(m.ax, m.ay));
+    return AmazonMove{SquareX(from), SquareY(from), SquareX(to), SquareY(to), SquareX(arrow), SquareY(arrow)};
+}
+
+uint64_t CanonicalBookKey(const AmazonBoard& board, int player, int& transform) {
+    // 8 个变换后的键一起累加，每个有子的格子只遍历一次
+    uint64_t keys[kNumSymmetries];
+    for (int t = 0; t < kNumSymmetries; t++) keys[t] = kZobrist.side[player];
+    Bitboard occupied = board.occupied;
+    while (occupied) {
+        int sq = PopLowestBit(occupied);
+        const uint64_t* table = kZobrist.pieces[board.GetPiece(SquareX(sq), SquareY(sq))];
+        for (int t = 0; t < kNumSymmetries; t++) keys[t] ^= table[kSymmetry.squares[t][sq]];
+    }
+    transform = 0;
+    for (int t = 1; t < kNumSymmetries; t++) {
+        if (keys[t] < keys[transform]) transform = t;
+    }
+    // 0 留给空槽
+    return keys[transform] ? keys[transform] : 1;
+}
+
+bool OpeningBook::open(const std::string& path) {
+    close();
+    if (!file.open(path) || file.size() < sizeof(BookHeader)) {
+        close();
+        return false;
+    }
+
+    // 校验文件头和文件大小，对不上就当没有开局库
+    const BookHeader* h = reinterpret_cast<const BookHeader*>(file.data());
+    bool valid = std::memcmp(h->magic, "AMZBOOK", 8) == 0 && h->version == kBookVersion &&
+                 h->entrySize == sizeof(BookEntry) && h->slotCount > 0 && (h->slotCount & (h->slotCount - 1)) == 0 &&
+                 h->entryCount < h->slotCount &&
+                 file.size() == sizeof(BookHeader) + h->slotCount * sizeof(BookEntry);
+    if (!valid) {
+        close();
+        return false;
+    }
+    header = h;
+    entries = reinterpret_cast<const BookEntry*>(file.data() + sizeof(BookHeader));
+    return true;
+}
+
+void OpeningBook::close() {
+    file.close();
+    header = nullptr;
+    entries = nullptr;
+}
+
+bool OpeningBook::probe(const AmazonBoard& board, int player, AmazonMove& out) const {
+    if (!isOpen() || header->entryCount == 0) return false;
+    int transform;
+    uint64_t key = CanonicalBookKey(board, player, transform);
+    uint64_t mask = header->slotCount - 1;
+    // 最多探测 slotCount 次：open() 只保证条目数少于槽数，文件被改坏（比如把空槽填上了）时也不会死循环
+    uint64_t i = key & mask;
+    for (uint64_t step = 0; step < header->slotCount; step++, i = (i + 1) & mask) {
+        const BookEntry& e = entries[i];
+        if (e.key == 0) return false;
+        if (e.key == key) {
+            // 库里存的是标准局面的动作，用逆变换换回实际局面
+            AmazonMove m = TransformMove(InverseSymmetry(transform), PackedMove(e.move).unpack());
+            if (!IsLegalMove(board, player, m)) return false;
+            out = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+void OpeningBookBuilder::add(const AmazonBoard& board, int player, const AmazonMove& m, uint32_t visits, double winRate) {
+    int transform;
+    uint64_t key = CanonicalBookKey(board, player, transform);
+    BookEntry e;
+    e.key = key;
+    e.move = PackedMove(TransformMove(transform, m)).bits;
+    e.visits = static_cast<uint16_t>(std::min<uint32_t>(visits, 65535));
+    e.winRate = static_cast<uint16_t>(std::min(1.0, std::max(0.0, winRate)) * 65535.0 + 0.5);
+    auto it = entries.find(key);
+    if (it == entries.end() || it->second.visits < e.visits) {
+        entries[key] = e;
+    }
+}
+
+bool OpeningBookBuilder::contains(const AmazonBoard& board, int player) const {
+    int transform;
+    return entries.count(CanonicalBookKey(board, player, transform)) != 0;
+}
+
+bool OpeningBookBuilder::write(const std::string& path) const {
+    uint64_t slots = 16;
+    while (slots < entries.size() * 2) slots <<= 1;
+    std::vector<BookEntry> table(slots);
+    std::memset(table.data(), 0, slots * sizeof(BookEntry));
+    for (const auto& kv : entries) {
+        uint64_t i = kv.first & (slots - 1);
+        while (table[i].key != 0) i = (i + 1) & (slots - 1);
+        table[i] = kv.second;
+    }
+
+    BookHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, "AMZBOOK", 8);
+    h.version = kBookVersion;
+    h.entrySize = sizeof(BookEntry);
+    h.slotCount = slots;
+    h.entryCount = entries.size();
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 && std::fwrite(table.data(), sizeof(BookEntry), slots, f) == slots;
+    return std::fclose(f) == 0 && ok;
+}
@@ -0,0 +1,76 @@
+#ifndef OPENING_BOOK_HPP
+#define OPENING_BOOK_HPP
+
+#include "Board.hpp"
+#include "MappedFile.hpp"
+#include "MoveGen.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// 棋盘的 8 种对称变换（恒等、左右翻、上下翻、转 180 度、沿两条对角线翻、转 90 度两个方向）
+const int kNumSymmetries = 8;
+
+// 格子 sq 在第 t 种变换下的位置
+int TransformSquare(int t, int sq);
+// 第 t 种变换的逆变换
+int InverseSymmetry(int t);
+AmazonMove TransformMove(int t, const AmazonMove& m);
+
+// 局面在 8 种变换下的 Zobrist 键里最小的那个（含轮到谁走），对称的局面得到同一个键。
+// transform 返回取到最小值的变换：原局面经过它变成"标准局面"
+uint64_t CanonicalBookKey(const AmazonBoard& board, int player, int& transform);
+
+// 开局库磁盘格式：文件头 + slotCount 个 16 字节的槽，开放寻址（线性探测），键为 0 的槽是空的，至少要有一个空槽。
+// 动作按标准局面存，查到后再变换回实际局面。整个文件直接 mmap 进来，不解析、不复制
+struct BookHeader {
+    char magic[8];        // "AMZBOOK\0"
+    uint32_t version;     // kBookVersion
+    uint32_t entrySize;   // sizeof(BookEntry)
+    uint64_t slotCount;   // 2 的幂
+    uint64_t entryCount;  // 实际存了多少个局面
+};
+
+struct BookEntry {
+    uint64_t key;
+    uint32_t move;     // PackedMove::bits
+    uint16_t visits;   // 建库时这个动作的访问数（饱和到 65535），越大越可靠
+    uint16_t winRate;  // 建库时这个动作的胜率 × 65535
+};
+
+const uint32_t kBookVersion = 1;
+
+// 只读的开局库，文件映射进内存，O(1) 查询。可以被多个引擎、多个线程同时查
+class OpeningBook {
+public:
+    // 映射并校验开局库文件，失败（不存在、格式或大小不对）时返回 false，库保持为空
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return entries != nullptr; }
+    size_t size() const { return isOpen() ? static_cast<size_t>(header->entryCount) : 0; }
+
+    // 查局面，命中并且动作在这个局面合法时写进 out
+    bool probe(const AmazonBoard& board, int player, AmazonMove& out) const;
+
+private:
+    MappedFile file;
+    const BookHeader* header = nullptr;
+    const BookEntry* entries = nullptr;
+};
+
+// 建库时在内存里攒条目，最后一次写成开局库文件
+class OpeningBookBuilder {
+public:
+    // 记录局面的推荐动作；同一个（对称意义下的）局面记录多次时保留访问数多的
+    void add(const AmazonBoard& board, int player, const AmazonMove& m, uint32_t visits, double winRate);
+    bool contains(const AmazonBoard& board, int player) const;
+    size_t size() const { return entries.size(); }
+    // 槽数取不小于条目数两倍的 2 的幂，装填率不超过一半，查询平均一两次探测
+    bool write(const std::string& path) const;
+
+private:
+    std::unordered_map<uint64_t, BookEntry> entries;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include "Replay.hpp"
+#include "MoveGen.hpp"
+#include <cstdlib>
+
+bool GameReplay::load(const std::vector<AmazonMove>& history) {
+    clear();
+    AmazonBoard board;
+    bool legal = true;
+    for (size_t i = 0; i < history.size(); i++) {
+        int player = PlayerOfPly(static_cast<int>(i));
+        if (!IsLegalMove(board, player, history[i])) {
+            legal = false;
+            break;
+        }
+        board.MakeMove(history[i], player);
+        moves.push_back(PackedMove(history[i]));
+        if (moves.size() % kSnapshotInterval == 0) snapshots.push_back(board);
+    }
+    last = board;
+    return legal;
+}
+
+void GameReplay::clear() {
+    moves.clear();
+    snapshots.assign(1, AmazonBoard());
+    current = AmazonBoard();
+    last = current;
+    currentPly = 0;
+}
+
+bool GameReplay::lastMove(AmazonMove& m) const {
+    if (currentPly == 0) return false;
+    m = moves[currentPly - 1].unpack();
+    return true;
+}
+
+void GameReplay::seek(int target) {
+    if (target < 0) target = 0;
+    if (target > size()) target = size();
+
+    // 三个出发点：当前局面、target 之前最近的快照、target 之后最近的快照
+    int before = target / kSnapshotInterval;
+    int from = currentPly;
+    int cost = std::abs(target - currentPly);
+    if (target - before * kSnapshotInterval < cost) {
+        from = before * kSnapshotInterval;
+        cost = target - from;
+    }
+    int after = before + 1;
+    if (after < static_cast<int>(snapshots.size()) && after * kSnapshotInterval - target < cost) {
+        from = after * kSnapshotInterval;
+    }
+    if (from != currentPly) {
+        current = snapshots[from / kSnapshotInterval];
+        currentPly = from;
+    }
+
+    while (currentPly < target) {
+        current.MakeMove(moves[currentPly], PlayerOfPly(currentPly));
+        currentPly++;
+    }
+    while (currentPly > target) {
+        currentPly--;
+        current.UnmakeMove(moves[currentPly], PlayerOfPly(currentPly));
+    }
+}
+
+bool GameReplay::stepForward() {
+    if (currentPly >= size()) return false;
+    seek(currentPly + 1);
+    return true;
+}
+
+bool GameReplay::stepBackward() {
+    if (currentPly == 0) return false;
+    seek(currentPly - 1);
+    return true;
+}
@@ -0,0 +1,45 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include "Board.hpp"
+#include <vector>
+
+// 复盘用的游标：可以跳到任意一步，也可以往回退。
+// 每 kSnapshotInterval 步存一份棋盘快照，跳转时从当前局面、前一个快照（往前走）或后一个快照（往回撤）
+// 里挑最近的出发，所以任何一次跳转最多走/撤 kSnapshotInterval / 2 步
+class GameReplay {
+public:
+    static const int kSnapshotInterval = 8;
+
+    GameReplay() { clear(); }
+
+    // 从初始局面按规则重走 moves（黑方先走），建好快照，游标停在第 0 步。
+    // 遇到不合法的动作就停下，只保留它前面的部分，返回 false
+    bool load(const std::vector<AmazonMove>& moves);
+    void clear();
+
+    int size() const { return static_cast<int>(moves.size()); } // 一共多少步
+    int ply() const { return currentPly; }                        // 当前已经走了几步
+    const AmazonBoard& board() const { return current; }
+    // 第 i 步（从 0 数）是谁走的
+    static int PlayerOfPly(int i) { return (i % 2 == 0) ? BLACK_QUEEN : WHITE_QUEEN; }
+    int playerToMove() const { return PlayerOfPly(currentPly); }
+    // 把游标移到的这一局面之前刚走的那一步，第 0 步时返回 false
+    bool lastMove(AmazonMove& m) const;
+    // 最后一步走完后的局面
+    const AmazonBoard& finalBoard() const { return last; }
+
+    // 跳到第 target 步之后的局面（超出范围时夹到 [0, size()]）
+    void seek(int target);
+    bool stepForward();
+    bool stepBackward();
+
+private:
+    std::vector<PackedMove> moves;
+    std::vector<AmazonBoard> snapshots; // snapshots[k] 是走完 k * kSnapshotInterval 步的局面
+    AmazonBoard current;
+    AmazonBoard last;
+    int currentPly = 0;
+};
+
+#endif
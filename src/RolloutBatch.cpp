@@ -0,0 +1,273 @@
+#include "RolloutBatch.hpp"
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AMAZONS_AVX2_KERNEL 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC / Clang 要给用到 AVX2 指令的函数单独打开指令集，整个程序仍按基础 x86-64 编译；MSVC 不需要
+#if defined(AMAZONS_AVX2_KERNEL) && (defined(__GNUC__) || defined(__clang__))
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+
+const char* SimdLevelName(SimdLevel level) {
+    return level == SIMD_AVX2 ? "avx2" : "scalar";
+}
+
+static SimdLevel detectSimdLevel() {
+#if defined(AMAZONS_AVX2_KERNEL)
+#if defined(_MSC_VER) && !defined(__clang__)
+    // CPU 支持 AVX2，操作系统也要在切换线程时保存 ymm 寄存器（XCR0 的第 1、2 位）
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return SIMD_SCALAR;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0;
+    if (!osxsave || !avx || !avx2 || (_xgetbv(0) & 6) != 6) return SIMD_SCALAR;
+    return SIMD_AVX2;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? SIMD_AVX2 : SIMD_SCALAR;
+#endif
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+SimdLevel DetectSimdLevel() {
+    static const SimdLevel detected = detectSimdLevel();
+    return detected;
+}
+
+static std::atomic<int> activeSimdLevel{-1};
+
+SimdLevel ActiveSimdLevel() {
+    int level = activeSimdLevel.load(std::memory_order_relaxed);
+    return level < 0 ? DetectSimdLevel() : static_cast<SimdLevel>(level);
+}
+
+SimdLevel SetSimdLevel(SimdLevel level) {
+    SimdLevel effective = level > DetectSimdLevel() ? DetectSimdLevel() : level;
+    activeSimdLevel.store(effective, std::memory_order_relaxed);
+    return effective;
+}
+
+#if defined(AMAZONS_AVX2_KERNEL)
+
+// 4 块棋盘同时平移，和 Bitboard.hpp 的 ShiftBy / SlideFill / SlideAttacks 一一对应
+template <int Shift, int Steps>
+AVX2_TARGET static inline __m256i shiftLanes(__m256i b) {
+    if constexpr (Shift > 0) {
+        return _mm256_slli_epi64(b, Shift * Steps);
+    } else {
+        return _mm256_srli_epi64(b, -Shift * Steps);
+    }
+}
+
+template <int Shift>
+AVX2_TARGET static inline __m256i slideAttacksLanes(__m256i sources, __m256i empty, __m256i mask) {
+    __m256i pro = _mm256_and_si256(empty, mask);
+    sources = _mm256_or_si256(sources, _mm256_and_si256(pro, shiftLanes<Shift, 1>(sources)));
+    pro = _mm256_and_si256(pro, shiftLanes<Shift, 1>(pro));
+    sources = _mm256_or_si256(sources, _mm256_and_si256(pro, shiftLanes<Shift, 2>(sources)));
+    pro = _mm256_and_si256(pro, shiftLanes<Shift, 2>(pro));
+    sources = _mm256_or_si256(sources, _mm256_and_si256(pro, shiftLanes<Shift, 4>(sources)));
+    return _mm256_and_si256(_mm256_and_si256(shiftLanes<Shift, 1>(sources), mask), empty);
+}
+
+struct QueenStepLanes {
+    AVX2_TARGET static inline __m256i step(__m256i frontier, __m256i empty) {
+        const __m256i notA = _mm256_set1_epi64x(static_cast<long long>(kNotFileA));
+        const __m256i notH = _mm256_set1_epi64x(static_cast<long long>(kNotFileH));
+        const __m256i all = _mm256_set1_epi64x(-1);
+        __m256i a = _mm256_or_si256(slideAttacksLanes<1>(frontier, empty, notA), slideAttacksLanes<-1>(frontier, empty, notH));
+        __m256i b = _mm256_or_si256(slideAttacksLanes<8>(frontier, empty, all), slideAttacksLanes<-8>(frontier, empty, all));
+        __m256i c = _mm256_or_si256(slideAttacksLanes<9>(frontier, empty, notA), slideAttacksLanes<7>(frontier, empty, notH));
+        __m256i d = _mm256_or_si256(slideAttacksLanes<-7>(frontier, empty, notA), slideAttacksLanes<-9>(frontier, empty, notH));
+        return _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+    }
+};
+
+// 每 4 个填充一组同步往外扩，直到 4 个都停下；某一道停下后它的 frontier 一直是 0，不会再写层
+template <typename Step>
+AVX2_TARGET static void floodLayersAvx2(const Bitboard* sources, const Bitboard* empty, DistanceLayers* out, int n) {
+    alignas(32) uint64_t src[4], emp[4], frontierOut[4], reachedOut[4];
+    for (int base = 0; base < n; base += 4) {
+        int lanes = n - base < 4 ? n - base : 4;
+        for (int i = 0; i < 4; i++) {
+            src[i] = i < lanes ? sources[base + i] : 0;
+            emp[i] = i < lanes ? empty[base + i] : 0;
+            if (i < lanes) out[base + i].count = 0;
+        }
+        __m256i e = _mm256_load_si256(reinterpret_cast<const __m256i*>(emp));
+        __m256i frontier = _mm256_load_si256(reinterpret_cast<const __m256i*>(src));
+        __m256i reached = _mm256_setzero_si256();
+        while (true) {
+            frontier = _mm256_andnot_si256(reached, _mm256_and_si256(Step::step(frontier, e), e));
+            if (_mm256_testz_si256(frontier, frontier)) break;
+            reached = _mm256_or_si256(reached, frontier);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(frontierOut), frontier);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(reachedOut), reached);
+            // 每道都写，frontier 为 0 的道不推进 count，下一层会覆盖掉（层数最多 63，不会越界）
+            for (int i = 0; i < lanes; i++) {
+                DistanceLayers& l = out[base + i];
+                l.reached[l.count] = reachedOut[i];
+                l.count += frontierOut[i] != 0;
+            }
+        }
+    }
+}
+
+// 和 SampleRandomMove 的 SAMPLE_UNIFORM 分支完全一样（同样的随机数消耗、同样的结果），
+// 只是每个 (女王, 落点) 的射箭集合 4 个一组用单源的 Kogge-Stone 填充一起算，不再逐个查射线表
+AVX2_TARGET static bool sampleUniformAvx2(const AmazonBoard& board, int player, std::mt19937& rng, AmazonMove& out) {
+    alignas(32) uint64_t targetBits[4 * 27], empty[4 * 27], arrowSets[4 * 27];
+    int froms[4 * 27];
+    int tos[4 * 27];
+    int n = 0;
+    Bitboard queens = board.Queens(player);
+    while (queens) {
+        int from = PopLowestBit(queens);
+        Bitboard targets = QueenAttacks(from, board.occupied);
+        Bitboard emptyAfterLeave = ~(board.occupied & ~SquareBit(from));
+        while (targets) {
+            int to = PopLowestBit(targets);
+            froms[n] = from;
+            tos[n] = to;
+            targetBits[n] = SquareBit(to);
+            empty[n] = emptyAfterLeave;
+            n++;
+        }
+    }
+    for (int i = n; i < ((n + 3) & ~3); i++) targetBits[i] = empty[i] = 0;
+
+    for (int i = 0; i < n; i += 4) {
+        __m256i arrows = QueenStepLanes::step(_mm256_load_si256(reinterpret_cast<const __m256i*>(targetBits + i)),
+                                              _mm256_load_si256(reinterpret_cast<const __m256i*>(empty + i)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(arrowSets + i), arrows);
+    }
+    int total = 0;
+    for (int i = 0; i < n; i++) total += PopCount(arrowSets[i]);
+    if (total == 0) return false;
+
+    int r = std::uniform_int_distribution<int>(0, total - 1)(rng);
+    int i = 0;
+    while (r >= PopCount(arrowSets[i])) {
+        r -= PopCount(arrowSets[i]);
+        i++;
+    }
+    int arrow = NthBit(arrowSets[i], r);
+    out = AmazonMove{SquareX(froms[i]), SquareY(froms[i]), SquareX(tos[i]), SquareY(tos[i]), SquareX(arrow), SquareY(arrow)};
+    return true;
+}
+
+#endif
+
+void BatchQueenLayers(const Bitboard* sources, const Bitboard* empty, DistanceLayers* out, int n) {
+#if defined(AMAZONS_AVX2_KERNEL)
+    if (ActiveSimdLevel() == SIMD_AVX2) {
+        floodLayersAvx2<QueenStepLanes>(sources, empty, out, n);
+        return;
+    }
+#endif
+    for (int i = 0; i < n; i++) QueenLayers(sources[i], empty[i], out[i]);
+}
+
+void BatchKingLayers(const Bitboard* sources, const Bitboard* empty, DistanceLayers* out, int n) {
+    // 国王一步只有几条指令，打包成 4 道省下的算力抵不过每层拆包写回的开销（实测 AVX2 反而慢三成），逐个用标量填
+    for (int i = 0; i < n; i++) KingLayers(sources[i], empty[i], out[i]);
+}
+
+bool SimdSampleRandomMove(const AmazonBoard& board, int player, std::mt19937& rng, AmazonMove& out, RolloutSampling mode) {
+#if defined(AMAZONS_AVX2_KERNEL)
+    if (mode == SAMPLE_UNIFORM && ActiveSimdLevel() == SIMD_AVX2) {
+        return sampleUniformAvx2(board, player, rng, out);
+    }
+#endif
+    return SampleRandomMove(board, player, rng, out, mode);
+}
+
+RolloutBatch::RolloutBatch() : queenLayers(2 * kMaxSize), kingLayers(2 * kMaxSize) {}
+
+int RolloutBatch::add(const AmazonBoard& board, int playerToMove) {
+    boards[count] = board;
+    players[count] = playerToMove;
+    return count++;
+}
+
+void RolloutBatch::run(const RolloutSettings& settings, int aiPlayer, std::mt19937& rng) {
+    for (int i = 0; i < count; i++) pending[i] = true;
+
+    // 所有局一起一步步往下走；无子可走的一方输，这一局就此结束
+    for (int step = 0; step < settings.depth; step++) {
+        for (int i = 0; i < count; i++) {
+            if (!pending[i]) continue;
+            AmazonMove m;
+            if (!SimdSampleRandomMove(boards[i], players[i], rng, m, settings.sampling)) {
+                results[i] = (players[i] == aiPlayer) ? 0.0 : 1.0;
+                pending[i] = false;
+                continue;
+            }
+            boards[i].MakeMove(m, players[i]);
+            players[i] = 3 - players[i];
+        }
+    }
+
+    // 没有走到终局的：先看是不是已经无子可走，双方分开时再数步数，小预算内能分出胜负就不用估了
+    if (settings.endgameSolver) solver.setMemoLimit(settings.endgameMemoEntries);
+    for (int i = 0; i < count; i++) {
+        if (!pending[i]) continue;
+        if (!HasAnyMove(boards[i], players[i])) {
+            results[i] = (players[i] == aiPlayer) ? 0.0 : 1.0;
+            pending[i] = false;
+            continue;
+        }
+        EndgameOutcome outcome;
+        if (settings.endgameSolver && solver.analyze(boards[i], players[i], outcome) && outcome.result != 0) {
+            bool moverWins = outcome.result > 0;
+            results[i] = (moverWins == (players[i] == aiPlayer)) ? 1.0 : 0.0;
+            pending[i] = false;
+        }
+    }
+
+    if (settings.leafEvaluation == EVAL_TERRITORY) {
+        evaluateTerritory(aiPlayer);
+    } else {
+        for (int i = 0; i < count; i++) {
+            if (pending[i]) results[i] = EvaluateMobility(boards[i], aiPlayer);
+        }
+    }
+}
+
+void RolloutBatch::evaluateTerritory(int aiPlayer) {
+    int ids[kMaxSize];
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (!pending[i]) continue;
+        Bitboard empty = ~boards[i].occupied;
+        fillSources[2 * n] = boards[i].Queens(aiPlayer);
+        fillSources[2 * n + 1] = boards[i].Queens(3 - aiPlayer);
+        fillEmpty[2 * n] = fillEmpty[2 * n + 1] = empty;
+        ids[n++] = i;
+    }
+    if (n == 0) return;
+
+    // 女王填充和国王填充分开批，同一组 4 道的层数接近，空转的少
+    BatchQueenLayers(fillSources, fillEmpty, queenLayers.data(), 2 * n);
+    BatchKingLayers(fillSources, fillEmpty, kingLayers.data(), 2 * n);
+    for (int j = 0; j < n; j++) {
+        int i = ids[j];
+        double tie = (players[i] == aiPlayer) ? kTerritoryTieBonus : -kTerritoryTieBonus;
+        TerritoryFeatures f = TerritoryFromLayers(queenLayers[2 * j], queenLayers[2 * j + 1], kingLayers[2 * j],
+                                                  kingLayers[2 * j + 1], tie);
+        results[i] = TerritoryWinProbability(TerritoryScore(f, PopCount(boards[i].arrows)));
+    }
+}
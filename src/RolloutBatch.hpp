@@ -0,0 +1,80 @@
+#ifndef ROLLOUT_BATCH_HPP
+#define ROLLOUT_BATCH_HPP
+
+#include "Board.hpp"
+#include "Endgame.hpp"
+#include "Evaluation.hpp"
+#include "MoveGen.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// 洪水填充内核用的指令集。启动时按 CPU 检测，检测不到（或不是 x86-64）就用标量版本，两者结果完全一样
+enum SimdLevel {
+    SIMD_SCALAR = 0,  // 一次填一块棋盘
+    SIMD_AVX2 = 1     // 一个 256 位寄存器放 4 块棋盘，4 个填充同步一层层往外扩
+};
+
+const char* SimdLevelName(SimdLevel level);
+// 这台机器支持的最高级别
+SimdLevel DetectSimdLevel();
+// 当前实际使用的级别，默认就是 DetectSimdLevel()
+SimdLevel ActiveSimdLevel();
+// 改用 level（超过机器支持的级别时按支持的算），返回实际生效的级别。对比基准用，搜索中途不要改
+SimdLevel SetSimdLevel(SimdLevel level);
+
+// 一次算 n 个填充：out[i] 是从 sources[i] 出发、在 empty[i] 里的女王/国王距离层，和 QueenLayers / KingLayers 一致
+void BatchQueenLayers(const Bitboard* sources, const Bitboard* empty, DistanceLayers* out, int n);
+void BatchKingLayers(const Bitboard* sources, const Bitboard* empty, DistanceLayers* out, int n);
+
+// 和 SampleRandomMove 结果完全一样（给定同样的随机数状态抽到同一个动作），SAMPLE_UNIFORM 在支持 AVX2 时快约三倍
+bool SimdSampleRandomMove(const AmazonBoard& board, int player, std::mt19937& rng, AmazonMove& out,
+                          RolloutSampling mode = SAMPLE_UNIFORM);
+
+// 模拟的参数，和 MCTSConfig 里的同名项对应
+struct RolloutSettings {
+    int depth = 4;
+    RolloutSampling sampling = SAMPLE_UNIFORM;
+    LeafEvaluation leafEvaluation = EVAL_TERRITORY;
+    bool endgameSolver = true;
+    // 求解器记忆表最多存多少项，0 表示不限
+    size_t endgameMemoEntries = 1 << 20;
+};
+
+// 一批互不相关的模拟：所有局面同步往下随机走（提前分出胜负的退出），走完后剩下的局面一起评估，
+// 领地评估的 4 个洪水填充按批交给 SIMD 内核。每个搜索线程一个，反复 clear / add / run，不做堆分配
+class RolloutBatch {
+public:
+    static constexpr int kMaxSize = 64;
+
+    RolloutBatch();
+
+    void clear() { count = 0; }
+    int size() const { return count; }
+    bool full() const { return count >= kMaxSize; }
+    // 加一局（复制 board），返回它在这一批里的编号
+    int add(const AmazonBoard& board, int playerToMove);
+    // 跑完这一批，之后 result(i) 是第 i 局 aiPlayer 视角的得分
+    void run(const RolloutSettings& settings, int aiPlayer, std::mt19937& rng);
+    double result(int i) const { return results[i]; }
+
+private:
+    int count = 0;
+    AmazonBoard boards[kMaxSize];
+    int players[kMaxSize];
+    double results[kMaxSize];
+    bool pending[kMaxSize];  // 还没有得分（没有提前分出胜负）
+
+    // 领地评估的填充输入输出，第 j 个待评估局面占 2j（aiPlayer）和 2j + 1（对方）两项
+    Bitboard fillSources[2 * kMaxSize];
+    Bitboard fillEmpty[2 * kMaxSize];
+    std::vector<DistanceLayers> queenLayers;
+    std::vector<DistanceLayers> kingLayers;
+
+    // 双方分开后数步数判胜负，记忆表跨批次保留
+    EndgameSolver solver{1000};
+
+    void evaluateTerritory(int aiPlayer);
+};
+
+#endif
@@ -0,0 +1,128 @@
+#include "SearchEngine.hpp"
+#include "AlphaBeta.hpp"
+#include "MCTS.hpp"
+#include "OpeningBook.hpp"
+
+SearchEngine::~SearchEngine() {
+    // 派生类应该已经停过了，这里只是兜底，避免 std::thread 带着可 join 的线程析构
+    StopSearch();
+}
+
+void SearchEngine::startClock(const SearchLimits& limits) {
+    hasDeadline = limits.timeLimitSeconds > 0.0;
+    if (hasDeadline) {
+        deadline = std::chrono::steady_clock::now() +
+                   std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                       std::chrono::duration<double>(limits.timeLimitSeconds));
+    }
+    stopFlag = false;
+    searchStarted = std::chrono::steady_clock::now();
+    searchNanos = -1;
+}
+
+void SearchEngine::stopClock() {
+    searchNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - searchStarted).count();
+}
+
+AmazonMove SearchEngine::GetBestMove(const AmazonBoard& currentBoard, int aiPlayer, const SearchLimits& limits) {
+    StopSearch();
+    usedBook = false;
+    searchNanos = 0;
+    // 没有合法走法就直接返回一个空动作
+    if (!prepareRoot(currentBoard, aiPlayer)) {
+        return rootFallback;
+    }
+    AmazonMove m;
+    if (bookMove(currentBoard, aiPlayer, m)) {
+        usedBook = true;
+        return m;
+    }
+    startClock(limits);
+    m = search(currentBoard, aiPlayer, limits);
+    stopClock();
+    return m;
+}
+
+void SearchEngine::StartSearch(const AmazonBoard& currentBoard, int aiPlayer, const SearchLimits& limits) {
+    StopSearch();
+    pondering = false;
+    // 没有合法动作或者开局库命中时结果已经有了，不开后台线程
+    searchSkipped = true;
+    usedBook = false;
+    searchNanos = 0;
+    if (!prepareRoot(currentBoard, aiPlayer)) {
+        searchResult = rootFallback;
+        return;
+    }
+    if (bookMove(currentBoard, aiPlayer, searchResult)) {
+        usedBook = true;
+        return;
+    }
+    searchSkipped = false;
+    startClock(limits);
+    searchRunning = true;
+    searchThread = std::thread([this, currentBoard, aiPlayer, limits] {
+        searchResult = search(currentBoard, aiPlayer, limits);
+        stopClock();
+        searchRunning = false;
+    });
+}
+
+void SearchEngine::StartPondering(const AmazonBoard& currentBoard, int playerToMove, int maxIterations) {
+    SearchLimits limits;
+    limits.iterations = maxIterations;
+    limits.timeLimitSeconds = 0.0;
+    // 对手不一定照着开局库走，思考时不查库
+    std::shared_ptr<const OpeningBook> book = std::move(openingBook);
+    StartSearch(currentBoard, playerToMove, limits);
+    openingBook = std::move(book);
+    pondering = true;
+}
+
+bool SearchEngine::bookMove(const AmazonBoard& board, int player, AmazonMove& out) const {
+    return openingBook && openingBook->probe(board, player, out);
+}
+
+void SearchEngine::StopSearch() {
+    stopFlag = true;
+    if (searchThread.joinable()) {
+        searchThread.join();
+    }
+}
+
+AmazonMove SearchEngine::WaitForResult() {
+    if (searchThread.joinable()) {
+        searchThread.join();
+    }
+    return searchResult;
+}
+
+AmazonMove SearchEngine::GetBestMoveSoFar() const {
+    if (searchSkipped || (searchThread.joinable() && !searchRunning)) {
+        return searchResult;
+    }
+    return currentBest();
+}
+
+SearchStats SearchEngine::GetSearchStats(int topMoves) const {
+    SearchStats stats;
+    stats.fromBook = usedBook;
+    if (usedBook) return stats;
+    int64_t nanos = searchNanos.load();
+    stats.searching = nanos < 0;
+    stats.pondering = stats.searching && pondering;
+    if (stats.searching) {
+        nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - searchStarted).count();
+    }
+    stats.seconds = nanos * 1e-9;
+    collectStats(stats, topMoves);
+    stats.iterationsPerSecond = stats.seconds > 0.0 ? stats.iterations / stats.seconds : 0.0;
+    return stats;
+}
+
+std::unique_ptr<SearchEngine> CreateEngine(EngineType type) {
+    if (type == ENGINE_ALPHABETA) {
+        return std::unique_ptr<SearchEngine>(new AlphaBeta);
+    }
+    return std::unique_ptr<SearchEngine>(new MCTS);
+}
@@ -0,0 +1,118 @@
+#ifndef SEARCH_ENGINE_HPP
+#define SEARCH_ENGINE_HPP
+
+#include "Board.hpp"
+#include "MoveGen.hpp"
+#include "SearchStats.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+// 一次搜索的预算，两项都给时先到者为准；都为 0 时一直搜到 StopSearch
+struct SearchLimits {
+    int iterations = 5000;         // MCTS 最多迭代多少次（每次迭代最多新建一个节点）、alpha-beta 最多搜多少个节点，0 表示不限
+    double timeLimitSeconds = 0.0; // 最多想多少秒（墙钟时间），0 表示不限
+};
+
+class OpeningBook;
+
+// 可以在运行时切换的搜索引擎
+enum EngineType {
+    ENGINE_MCTS = 0,      // 蒙特卡洛树搜索
+    ENGINE_ALPHABETA = 1  // 迭代加深的 alpha-beta（PVS）
+};
+
+// 搜索引擎的公共接口。同步/异步搜索、后台思考、截止时间这些和算法无关的部分在这里实现，
+// 派生类只提供 prepareRoot / search / currentBest 和树根推进。
+// 派生类的析构函数必须先调用 StopSearch()：后台线程用到的是派生类的成员
+class SearchEngine {
+public:
+    virtual ~SearchEngine();
+
+    // 同步搜索，返回最佳动作（正在进行的后台搜索会先被停掉）；没有合法动作时返回全 0 的动作
+    AmazonMove GetBestMove(const AmazonBoard& currentBoard, int aiPlayer, const SearchLimits& limits);
+
+    // --- 异步搜索：在后台线程里思考，界面线程照常绘制 ---
+    // 开始在 currentBoard 上为 aiPlayer 搜索（正在进行的搜索会先被停掉）
+    void StartSearch(const AmazonBoard& currentBoard, int aiPlayer, const SearchLimits& limits);
+    // 后台搜索是否还在进行（预算用完或被停止后返回 false）
+    bool IsSearching() const { return searchRunning.load(); }
+    // 让后台搜索尽快停下并等它退出；没有搜索时什么也不做
+    void StopSearch();
+    // 当前为止的最佳动作，搜索进行中也可以随时调用
+    AmazonMove GetBestMoveSoFar() const;
+    // 等后台搜索按预算结束（不会提前打断），返回最终的最佳动作
+    AmazonMove WaitForResult();
+
+    // --- 后台思考（pondering）：对手思考时在当前局面上继续搜索 ---
+    // playerToMove 是正在思考的对手。对手落子后先 AdvanceRoot(对手的动作)，它会停掉后台思考并保留有用的结果，
+    // 接着 StartSearch / GetBestMove 就在这些结果上继续。maxIterations 防止对手想太久时占用的内存无限增长
+    void StartPondering(const AmazonBoard& currentBoard, int playerToMove, int maxIterations = 1000000);
+    bool IsPondering() const { return pondering && searchRunning.load(); }
+
+    // 最近一次搜索的统计：GetBestMove / WaitForResult 返回之后调用就是这一步的统计，
+    // 搜索（包括后台思考）进行中调用是到目前为止的值，可以每帧读来画界面。topMoves 是最多列出几个根孩子
+    SearchStats GetSearchStats(int topMoves = 5) const;
+
+    // 告诉引擎某一方实际走了 m（bot 自己的也要告诉），引擎据此保留还有用的搜索结果
+    virtual void AdvanceRoot(const AmazonMove& m) = 0;
+    // 丢弃保留的搜索结果（新开一局、读档时调用；不调用也行，引擎发现局面对不上会自己重建）
+    virtual void ResetTree() = 0;
+    // 引擎名字，界面上显示用
+    virtual const char* Name() const = 0;
+
+    // 开局库，可以几个引擎共用一个。设置后 GetBestMove / StartSearch 先查库，命中就直接走库里的动作，不搜索；
+    // 后台思考不查库。传空指针取消
+    void SetOpeningBook(std::shared_ptr<const OpeningBook> book) { openingBook = std::move(book); }
+
+protected:
+    std::atomic<bool> stopFlag{false};  // 外部要求停止，或者到了截止时间
+    bool hasDeadline = false;
+    std::chrono::steady_clock::time_point deadline;
+    AmazonMove rootFallback = {0, 0, 0, 0, 0, 0}; // 树根的第一个合法动作，还没有任何结果时返回它
+
+    // 搜索开始前在调用线程里准备树根，返回根局面是否还有合法动作（没有时 rootFallback 就是要返回的空动作）
+    virtual bool prepareRoot(const AmazonBoard& currentBoard, int aiPlayer) = 0;
+    // 在准备好的树根上按预算搜索，返回最佳动作；要经常检查 timeUp()
+    virtual AmazonMove search(const AmazonBoard& currentBoard, int aiPlayer, const SearchLimits& limits) = 0;
+    // 搜索进行中到目前为止的最佳动作（可能和搜索线程同时调用）
+    virtual AmazonMove currentBest() const = 0;
+    // 填上引擎自己的统计（迭代数、树大小、深度、根孩子……），可能和搜索线程同时调用
+    virtual void collectStats(SearchStats& stats, int topMoves) const = 0;
+
+    // 被要求停止或者过了截止时间；过了截止时间会顺便置上 stopFlag，其他线程看一眼标志就够了
+    bool timeUp() {
+        if (stopFlag.load(std::memory_order_relaxed)) return true;
+        if (hasDeadline && std::chrono::steady_clock::now() >= deadline) {
+            stopFlag = true;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    // 后台搜索线程和它的状态
+    std::thread searchThread;
+    std::atomic<bool> searchRunning{false};
+    bool pondering = false;  // 当前（或最近一次）后台搜索是不是在对手回合的 pondering
+    AmazonMove searchResult = {0, 0, 0, 0, 0, 0};
+    bool searchSkipped = false; // 最近一次 StartSearch 没开线程，searchResult 直接就是结果
+    bool usedBook = false;      // 最近一次搜索是开局库给的
+    std::chrono::steady_clock::time_point searchStarted;
+    std::atomic<int64_t> searchNanos{0}; // 最近一次搜索用了多久，-1 表示还在搜
+    std::shared_ptr<const OpeningBook> openingBook;
+
+    // 查开局库，命中时写进 out
+    bool bookMove(const AmazonBoard& board, int player, AmazonMove& out) const;
+
+    // 按 limits 设好截止时间并清掉停止标志，开始给这次搜索计时
+    void startClock(const SearchLimits& limits);
+    // 这次搜索结束，记下用时
+    void stopClock();
+};
+
+// 按类型创建一个引擎
+std::unique_ptr<SearchEngine> CreateEngine(EngineType type);
+
+#endif
@@ -0,0 +1,34 @@
+#include "SearchStats.hpp"
+
+const char* SearchPhaseName(int phase) {
+    static const char* const names[kNumSearchPhases] = {"select", "expand", "movegen", "simulate", "backprop"};
+    return (phase >= 0 && phase < kNumSearchPhases) ? names[phase] : "?";
+}
+
+void SharedSearchCounters::reset() {
+    iterations.store(0, std::memory_order_relaxed);
+    maxDepth.store(0, std::memory_order_relaxed);
+    for (auto& n : phaseNanos) n.store(0, std::memory_order_relaxed);
+}
+
+void SharedSearchCounters::merge(SearchCounters& local) {
+    iterations.fetch_add(local.iterations, std::memory_order_relaxed);
+    int depth = maxDepth.load(std::memory_order_relaxed);
+    while (local.maxDepth > depth && !maxDepth.compare_exchange_weak(depth, local.maxDepth, std::memory_order_relaxed)) {
+    }
+    for (int p = 0; p < kNumSearchPhases; p++) {
+        if (local.phaseNanos[p]) phaseNanos[p].fetch_add(local.phaseNanos[p], std::memory_order_relaxed);
+    }
+    local = SearchCounters();
+}
+
+void SharedSearchCounters::fill(SearchStats& stats) const {
+    stats.iterations = iterations.load(std::memory_order_relaxed);
+    stats.maxDepth = maxDepth.load(std::memory_order_relaxed);
+#ifdef AMAZONS_SEARCH_PROFILE
+    stats.phasesTimed = true;
+#endif
+    for (int p = 0; p < kNumSearchPhases; p++) {
+        stats.phaseSeconds[p] = phaseNanos[p].load(std::memory_order_relaxed) * 1e-9;
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef SEARCH_STATS_HPP
+#define SEARCH_STATS_HPP
+
+#include "Board.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 搜索的几个阶段。编译时定义 AMAZONS_SEARCH_PROFILE（cmake -DAMAZONS_SEARCH_PROFILE=ON）才分别计时，
+// 否则 SEARCH_TIMER 展开成空语句，热路径上没有任何开销
+enum SearchPhase {
+    PHASE_SELECT = 0,   // 沿树往下选孩子
+    PHASE_EXPAND,       // 建新节点（不含生成动作）
+    PHASE_MOVEGEN,      // 数合法动作、按下标或启发分取出要展开的动作
+    PHASE_SIMULATE,     // 随机模拟和叶子评估（模拟里抽随机动作的时间也算在这里）
+    PHASE_BACKPROP,     // 回溯更新统计和置换表
+    kNumSearchPhases
+};
+
+const char* SearchPhaseName(int phase);
+
+// 树根一个孩子的统计
+struct RootChildStats {
+    AmazonMove move;
+    uint32_t visits;
+    double winRate; // 树根走棋一方走了 move 之后的平均得分
+};
+
+// 一次搜索的统计。搜索结束后是这一步的最终结果，搜索进行中（包括后台思考）是到目前为止的值
+struct SearchStats {
+    bool searching = false;      // 搜索还在进行
+    bool pondering = false;      // 是对手回合的后台思考
+    bool fromBook = false;       // 开局库命中，没有搜索
+    bool solved = false;         // 残局求解器直接算出来的动作
+    double seconds = 0.0;
+    uint64_t iterations = 0;     // MCTS 的迭代（模拟）次数；alpha-beta 的节点数
+    double iterationsPerSecond = 0.0;
+    size_t treeNodes = 0;        // MCTS 主搜索树的节点数
+    int maxDepth = 0;            // MCTS 选择阶段走到的最深层数；alpha-beta 完整搜完的深度
+    int prunes = 0;              // 这次搜索里树长满回收子树的次数
+    int score = 0;               // alpha-beta 根节点分数（轮到走的一方视角）
+    std::vector<RootChildStats> topMoves; // 访问数最多的几个根孩子（alpha-beta 只有当前最佳动作）
+    bool phasesTimed = false;    // 各阶段计时编译进来了没有
+    double phaseSeconds[kNumSearchPhases] = {}; // 各阶段用时，所有搜索线程加起来
+};
+
+// 一个搜索线程自己累加的计数，攒一批再并进 SharedSearchCounters，热路径上不碰共享的原子量
+struct SearchCounters {
+    uint64_t iterations = 0;
+    int maxDepth = 0;
+    uint64_t phaseNanos[kNumSearchPhases] = {};
+};
+
+// 所有搜索线程共享的计数，搜索进行中也可以随时读
+class SharedSearchCounters {
+public:
+    void reset();
+    // 把 local 加进来并清零（maxDepth 取较大的）
+    void merge(SearchCounters& local);
+    void fill(SearchStats& stats) const;
+
+private:
+    std::atomic<uint64_t> iterations{0};
+    std::atomic<int> maxDepth{0};
+    std::atomic<uint64_t> phaseNanos[kNumSearchPhases] = {};
+};
+
+#ifdef AMAZONS_SEARCH_PROFILE
+// 作用域结束时把经过的时间加到 counters.phaseNanos[phase]
+class ScopedPhaseTimer {
+public:
+    ScopedPhaseTimer(SearchCounters& c, SearchPhase p) : counters(c), phase(p), start(std::chrono::steady_clock::now()) {}
+    ~ScopedPhaseTimer() {
+        counters.phaseNanos[phase] += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+private:
+    SearchCounters& counters;
+    SearchPhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+#define SEARCH_TIMER_CONCAT2(a, b) a##b
+#define SEARCH_TIMER_CONCAT(a, b) SEARCH_TIMER_CONCAT2(a, b)
+#define SEARCH_TIMER(counters, phase) ScopedPhaseTimer SEARCH_TIMER_CONCAT(searchTimer, __LINE__)(counters, phase)
+#else
+#define SEARCH_TIMER(counters, phase) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,228 @@
+#include "SearchTree.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+SearchTree::SearchTree() {
+    for (int i = 0; i < kMaxChunks; i++) {
+        chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SearchTree::~SearchTree() {
+    for (int i = 0; i < kMaxChunks; i++) {
+        delete[] chunks[i].load(std::memory_order_relaxed);
+    }
+}
+
+NodeIndex SearchTree::allocate(int count) {
+    // 剩余空间放不下就跳到下一个分块的开头，保证一块孩子在内存里是连续的
+    NodeIndex start, end;
+    NodeIndex cur = next.load(std::memory_order_relaxed);
+    do {
+        start = cur;
+        uint32_t offset = start & (kChunkSize - 1);
+        if (offset != 0 && offset + count > kChunkSize) {
+            start += kChunkSize - offset;
+        }
+        end = start + count;
+        if (end > limit) {
+            exhausted.store(true, std::memory_order_relaxed);
+            return kNullNode;
+        }
+    } while (!next.compare_exchange_weak(cur, end, std::memory_order_relaxed));
+
+    // 分块保留到树析构，清空后再次分配时直接复用
+    int lastChunk = static_cast<int>((end - 1) >> kChunkBits);
+    if (!chunks[lastChunk].load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> guard(chunkMutex);
+        for (int c = static_cast<int>(start >> kChunkBits); c <= lastChunk; c++) {
+            if (!chunks[c].load(std::memory_order_relaxed)) {
+                chunks[c].store(new MCTSNode[kChunkSize], std::memory_order_release);
+                numChunks.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    return start;
+}
+
+void SearchTree::setCapacity(size_t nodes) {
+    size_t maxNodes = static_cast<size_t>(kMaxChunks) * kChunkSize;
+    if (nodes == 0 || nodes > maxNodes) nodes = maxNodes;
+    limit = static_cast<NodeIndex>(std::max<size_t>(1, nodes >> kChunkBits) << kChunkBits);
+
+    // 超出容量、也没有节点在用的分块还给系统
+    size_t used = std::max<size_t>(limit, next.load(std::memory_order_relaxed));
+    int keep = static_cast<int>((used + kChunkSize - 1) >> kChunkBits);
+    for (int c = keep; c < kMaxChunks; c++) {
+        MCTSNode* chunk = chunks[c].load(std::memory_order_relaxed);
+        if (chunk) {
+            delete[] chunk;
+            chunks[c].store(nullptr, std::memory_order_relaxed);
+            numChunks.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+NodeIndex SearchTree::resetRoot(int player) {
+    clear();
+    root = allocate(1);
+    node(root).init(player, AmazonMove{0, 0, 0, 0, 0, 0});
+    return root;
+}
+
+NodeIndex SearchTree::addChild(NodeIndex parent, const AmazonMove& m, uint8_t prior) {
+    MCTSNode& p = node(parent);
+    int created = p.numChildren();
+    NodeIndex child;
+    if (created == 0 || p.lastChild + 1 == p.blockEnd) {
+        // 当前块满了：新块大小和已有孩子数相当（至少 4 个），但不超过还没展开的动作数
+        int blockSize = std::min(p.legalMoves() - created, std::max(4, created));
+        child = allocate(blockSize);
+        if (child == kNullNode) return kNullNode;
+        p.blockEnd = child + blockSize;
+    } else {
+        child = p.lastChild + 1;
+    }
+
+    node(child).init(3 - p.playerToMove, m, prior);
+    if (created == 0) {
+        p.firstChild = child;
+    } else {
+        node(p.lastChild).nextSibling = child;
+    }
+    p.lastChild = child;
+    // 孩子和链接都写好了再发布孩子数，别的线程按这个数遍历孩子
+    p.nextUntried.store(static_cast<int16_t>(created + 1), std::memory_order_release);
+    return child;
+}
+
+// priorCode 解码成概率，查表代替每次算 exp2
+struct PriorTable {
+    float values[256];
+    PriorTable() {
+        for (int i = 0; i < 256; i++) values[i] = std::exp2(-i / 8.0f);
+    }
+};
+static const PriorTable kPriorTable;
+
+NodeIndex SearchTree::selectChild(NodeIndex parent, float c, bool puct, const TranspositionTable* tt, uint64_t parentHash) const {
+    const MCTSNode& p = node(parent);
+    int mover = p.playerToMove;
+    uint64_t childBase = parentHash ^ kZobrist.side[3 - mover]; // 孩子局面轮到对方走
+    NodeIndex best = kNullNode;
+    float bestUCB = -1e9;
+    // 对所有孩子都一样的部分只算一次
+    float parentVisits = static_cast<float>(p.visits.load(std::memory_order_relaxed));
+    float logVisits = puct ? 0.0f : std::log(parentVisits + 1.0f);
+    float puctScale = puct ? c * std::sqrt(parentVisits) : 0.0f;
+    int n = p.numChildren(); // 先读孩子数（acquire），再读链接
+    NodeIndex idx = n > 0 ? p.firstChild : kNullNode; // 没有孩子时 firstChild 可能正被别的线程写
+    for (int k = 0; k < n; k++) {
+        const MCTSNode& child = node(idx);
+        float visits = static_cast<float>(child.visits.load(std::memory_order_relaxed));
+        // 还没有得分的孩子（只有虚拟访问）按五五开算
+        float mean = visits > 0.0f ? static_cast<float>(child.wins()) / visits : 0.5f;
+        if (tt && child.transposed.load(std::memory_order_relaxed)) {
+            PackedMove m = child.move;
+            uint64_t key = childBase ^ ZobristMoveDelta(m.from(), m.to(), m.arrow(), mover);
+            uint32_t sharedVisits;
+            double sharedWins;
+            if (tt->probe(key, sharedVisits, sharedWins) && sharedVisits > visits) {
+                mean = static_cast<float>(sharedWins / sharedVisits);
+            }
+        }
+        // 探索项仍然用这条边自己的访问数
+        float ucb;
+        if (puct) {
+            ucb = mean + puctScale * kPriorTable.values[child.priorCode] / (1.0f + visits);
+        } else {
+            ucb = mean + c * std::sqrt(logVisits / (visits + 1e-6f));
+        }
+        if (ucb > bestUCB) {
+            bestUCB = ucb;
+            best = idx;
+        }
+        if (k + 1 < n) idx = child.nextSibling;
+    }
+    return best;
+}
+
+NodeIndex SearchTree::findChild(NodeIndex parent, const AmazonMove& move) const {
+    PackedMove m(move);
+    const MCTSNode& p = node(parent);
+    int n = p.numChildren();
+    NodeIndex c = n > 0 ? p.firstChild : kNullNode;
+    for (int k = 0; k < n; k++) {
+        const MCTSNode& child = node(c);
+        if (child.move == m) {
+            return c;
+        }
+        if (k + 1 < n) c = child.nextSibling;
+    }
+    return kNullNode;
+}
+
+void SearchTree::copySubtree(const SearchTree& src, NodeIndex from, uint32_t minVisits) {
+    clear();
+    root = allocate(1);
+
+    // 广度优先复制：(源节点, 目标位置, 目标节点的下一个兄弟)
+    struct Pending { NodeIndex src, dst, nextSibling; };
+    std::vector<Pending> queue;
+    queue.push_back({from, root, kNullNode});
+    for (size_t head = 0; head < queue.size(); head++) {
+        Pending item = queue[head];
+        const MCTSNode& s = src.node(item.src);
+        MCTSNode& d = node(item.dst);
+        d.copyFrom(s);
+        d.nextSibling = item.nextSibling;
+
+        int n = s.visits.load(std::memory_order_relaxed) >= minVisits ? s.numChildren() : 0;
+        // allocate 可能申请了新分块，但分块不会移动，d 依然有效
+        NodeIndex block = n > 0 ? allocate(n) : kNullNode;
+        if (block == kNullNode) {
+            // 截断成叶子：动作数和展开顺序还在，孩子从头重新展开
+            d.firstChild = d.lastChild = d.blockEnd = kNullNode;
+            d.nextUntried.store(0, std::memory_order_relaxed);
+            continue;
+        }
+        d.firstChild = block;
+        d.lastChild = block + n - 1;
+        d.blockEnd = block + n;
+        NodeIndex c = s.firstChild;
+        for (int k = 0; k < n; k++) {
+            queue.push_back({c, block + k, k + 1 < n ? block + k + 1 : kNullNode});
+            c = src.node(c).nextSibling;
+        }
+    }
+    // 截断是有意的，不算容量用完
+    exhausted.store(false, std::memory_order_relaxed);
+}
+
+uint32_t SearchTree::pruneThreshold(size_t maxNodes) const {
+    // byLevel[b]：访问数在 [2^b, 2^(b+1)) 之间的节点的孩子总数。阈值取 2^k 时保留 1 + sum(byLevel[b], b >= k) 个节点
+    size_t byLevel[33] = {};
+    std::vector<NodeIndex> stack;
+    if (root != kNullNode) stack.push_back(root);
+    while (!stack.empty()) {
+        const MCTSNode& n = node(stack.back());
+        stack.pop_back();
+        uint32_t visits = n.visits.load(std::memory_order_relaxed);
+        int count = n.numChildren();
+        if (visits == 0 || count == 0) continue;
+        byLevel[HighestBit(visits)] += count;
+        NodeIndex c = n.firstChild;
+        for (int k = 0; k < count; k++) {
+            stack.push_back(c);
+            c = node(c).nextSibling;
+        }
+    }
+
+    size_t kept = 1;
+    int level = 32;
+    while (level > 0 && kept + byLevel[level - 1] <= maxNodes) {
+        kept += byLevel[--level];
+    }
+    return level >= 32 ? 0xFFFFFFFFu : (1u << level);
+}
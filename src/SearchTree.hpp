@@ -0,0 +1,189 @@
+#ifndef SEARCH_TREE_HPP
+#define SEARCH_TREE_HPP
+
+#include "MoveGen.hpp"
+#include "TranspositionTable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+
+// 节点之间用下标连接，不用指针：整棵树住在 SearchTree 的分块数组里，清空只需把分配位置归零
+typedef uint32_t NodeIndex;
+const NodeIndex kNullNode = 0xFFFFFFFFu;
+
+// 一盘棋最多 56 步（64 格减去 8 个女王，每步放一支箭），树深不会超过它
+const int kMaxTreeDepth = 64;
+
+// 搜索树节点。节点不保存棋盘，棋盘在每次迭代从根沿路径重新走出来；
+// 孩子也不一次性全部创建，只记录合法动作数和下一个待展开的序号，第一次被选中时才建出来。
+// 多线程搜索时：统计量是原子量，随便哪个线程都能加；
+// 数合法动作和展开孩子要先拿到节点自己的自旋锁，孩子建好之后才发布新的 nextUntried。
+// 遍历孩子时先读孩子数再读链接，并且不去读最后一个孩子的 nextSibling（别的线程可能正在写它）
+struct MCTSNode {
+    // 得分用定点数存，这样多线程累加也只是一次 fetch_add
+    static constexpr double kWinScale = 65536.0;
+
+    // selectChild 遍历孩子时只读这三个字段，放在一起
+    std::atomic<uint32_t> visits;
+    NodeIndex nextSibling;            // 同一个父节点的下一个孩子
+    std::atomic<uint64_t> winsFixed;  // 从走出 move 的那一方（即 3 - playerToMove）视角累计的得分 × kWinScale
+
+    NodeIndex firstChild;  // 第一个孩子
+    NodeIndex lastChild;   // 最近展开的孩子
+    NodeIndex blockEnd;    // 当前孩子块的尾后下标，孩子先填满块再申请新块
+
+    std::atomic<int16_t> numLegalMoves; // 该局面的合法动作数，-1 表示还没数过
+    std::atomic<int16_t> nextUntried;   // 已经展开了多少个孩子（也就是孩子个数）
+    int16_t untriedStride; // 与 numLegalMoves 互质的步长，第 k 个展开的是 (k * stride + offset) % n 号动作
+    int16_t untriedOffset;
+
+    PackedMove move;       // 到达此状态的动作
+    uint8_t playerToMove;  // 谁在该节点下棋
+    std::atomic<uint8_t> lockFlag;
+    std::atomic<uint8_t> transposed; // 置换表里这个局面的访问数比节点多，说明别的路径也到过它，选择时才去查表
+    uint8_t priorCode;     // 先验概率 2^(-priorCode / 8)，只在 PUCT 选择时用；整个节点 48 字节
+
+    void init(int player, const AmazonMove& m, uint8_t prior = 0) {
+        visits.store(0, std::memory_order_relaxed);
+        winsFixed.store(0, std::memory_order_relaxed);
+        nextSibling = firstChild = lastChild = blockEnd = kNullNode;
+        numLegalMoves.store(-1, std::memory_order_relaxed);
+        nextUntried.store(0, std::memory_order_relaxed);
+        untriedStride = 1;
+        untriedOffset = 0;
+        move = PackedMove(m);
+        playerToMove = static_cast<uint8_t>(player);
+        lockFlag.store(0, std::memory_order_relaxed);
+        transposed.store(0, std::memory_order_relaxed);
+        priorCode = prior;
+    }
+
+    // 原子量不能直接赋值，复制子树时逐个字段拷贝（只在没有搜索线程运行时调用）
+    void copyFrom(const MCTSNode& o) {
+        visits.store(o.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        winsFixed.store(o.winsFixed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        nextSibling = o.nextSibling;
+        firstChild = o.firstChild;
+        lastChild = o.lastChild;
+        blockEnd = o.blockEnd;
+        numLegalMoves.store(o.numLegalMoves.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        nextUntried.store(o.nextUntried.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        untriedStride = o.untriedStride;
+        untriedOffset = o.untriedOffset;
+        move = o.move;
+        playerToMove = o.playerToMove;
+        lockFlag.store(0, std::memory_order_relaxed);
+        transposed.store(o.transposed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        priorCode = o.priorCode;
+    }
+
+    void lock() {
+        while (lockFlag.exchange(1, std::memory_order_acquire)) {
+            while (lockFlag.load(std::memory_order_relaxed)) {
+            }
+        }
+    }
+    void unlock() { lockFlag.store(0, std::memory_order_release); }
+
+    double wins() const { return winsFixed.load(std::memory_order_relaxed) / kWinScale; }
+    void addWins(double result) {
+        winsFixed.fetch_add(static_cast<uint64_t>(result * kWinScale + 0.5), std::memory_order_relaxed);
+    }
+
+    int legalMoves() const { return numLegalMoves.load(std::memory_order_acquire); }
+    int numChildren() const { return nextUntried.load(std::memory_order_acquire); }
+    bool isFullyExpanded() const { return numChildren() >= legalMoves(); }
+
+    // 先验概率按对数量化成一个字节，精度约 9%，PUCT 够用了
+    static uint8_t encodePrior(float p) {
+        float code = -8.0f * std::log2(std::max(p, 1e-12f));
+        return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, code + 0.5f)));
+    }
+
+    // 下一个要展开的动作在 MoveAtIndex 顺序中的序号（持有锁时调用）
+    int nextUntriedIndex() const {
+        return (numChildren() * untriedStride + untriedOffset) % legalMoves();
+    }
+};
+static_assert(sizeof(MCTSNode) == 48, "MCTSNode 应该正好 48 字节，树的内存预算按这个算");
+
+// 一次搜索用的节点池。节点按块存放在固定大小的分块里，分块一旦申请就不会移动，
+// 同一个父节点的孩子尽量连续（块大小按孩子数倍增），clear() 是 O(1) 的，分块留给下一次搜索复用。
+// 节点数有上限（setCapacity），到了上限 allocate 失败、full() 变成 true，树不再长大但已有节点照常可用。
+// allocate 可以被多个搜索线程同时调用
+class SearchTree {
+public:
+    static const int kChunkBits = 16;
+    static const uint32_t kChunkSize = 1u << kChunkBits;
+    static const int kMaxChunks = 1024; // 最多 6400 万个节点
+
+    NodeIndex root = kNullNode;
+
+    SearchTree();
+    ~SearchTree();
+    SearchTree(const SearchTree&) = delete;
+    SearchTree& operator=(const SearchTree&) = delete;
+
+    MCTSNode& node(NodeIndex i) { return chunks[i >> kChunkBits].load(std::memory_order_relaxed)[i & (kChunkSize - 1)]; }
+    const MCTSNode& node(NodeIndex i) const { return chunks[i >> kChunkBits].load(std::memory_order_relaxed)[i & (kChunkSize - 1)]; }
+
+    // 丢弃整棵树并建一个新的根
+    NodeIndex resetRoot(int player);
+
+    // 给 parent 建出下一个孩子（动作 m，先验 prior 是 encodePrior 的结果），返回孩子下标；同时发布 parent 新的孩子数。
+    // 调用方持有 parent 的锁。节点池用完时返回 kNullNode，parent 保持不变
+    NodeIndex addChild(NodeIndex parent, const AmazonMove& m, uint8_t prior = 0);
+
+    // 在 parent 已展开的孩子里找动作为 m 的那个，没有就返回 kNullNode
+    NodeIndex findChild(NodeIndex parent, const AmazonMove& m) const;
+
+    // 把 src 中以 from 为根的子树复制进本树（先清空）作为新根，其余节点全部丢弃。
+    // 复制后每个节点的孩子恰好占一整块连续空间。
+    // 访问数少于 minVisits 的节点只复制它自己，孩子丢掉（统计量保留，以后被选中时重新展开）；
+    // 本树容量不够时按广度优先的顺序复制，放不下的节点也这样截断
+    void copySubtree(const SearchTree& src, NodeIndex from, uint32_t minVisits = 0);
+
+    // 找一个 2 的幂 minVisits，使 copySubtree(*this, root, minVisits) 复制出的节点数不超过 maxNodes。
+    // 子节点的访问数不超过父节点，所以访问数够的节点一定挂在访问数够的父节点下面，统计一遍就够了
+    uint32_t pruneThreshold(size_t maxNodes) const;
+
+    // 选择最佳子节点，c 是探索系数。默认用 UCB1；puct 为 true 时用 PUCT：Q + c * P * sqrt(N) / (1 + n)，
+    // P 是孩子的先验，每个孩子不用算 log 和 sqrt。
+    // 给了置换表 tt 时，标记为 transposed 的孩子去表里查，表里的访问数比孩子节点自己多（别的走子顺序也到过这个局面），
+    // 平均得分就改用表里的；parentHash 是 parent 局面的棋盘哈希 AmazonBoard::hash
+    NodeIndex selectChild(NodeIndex parent, float c, bool puct = false,
+                          const TranspositionTable* tt = nullptr, uint64_t parentHash = 0) const;
+
+    // 清空所有节点，O(1)。不能和搜索线程同时调用
+    void clear() {
+        next.store(0, std::memory_order_relaxed);
+        exhausted.store(false, std::memory_order_relaxed);
+        root = kNullNode;
+    }
+
+    // 最多放多少个节点，向下取整到整分块（至少一块），0 表示用满 kMaxChunks。
+    // 缩小时释放用不到的分块。不能和搜索线程同时调用
+    void setCapacity(size_t nodes);
+    size_t capacity() const { return limit; }
+    // 有节点因为容量用完没分配出来
+    bool full() const { return exhausted.load(std::memory_order_relaxed); }
+
+    size_t nodeCount() const { return next.load(std::memory_order_relaxed); }
+    size_t memoryBytes() const { return numChunks.load(std::memory_order_relaxed) * kChunkSize * sizeof(MCTSNode); }
+
+private:
+    std::atomic<MCTSNode*> chunks[kMaxChunks];
+    std::atomic<int> numChunks{0};
+    std::mutex chunkMutex;            // 只在申请新分块时用
+    std::atomic<NodeIndex> next{0};   // 下一个空闲下标
+    NodeIndex limit = static_cast<NodeIndex>(kMaxChunks) * kChunkSize; // 节点数上限，整分块
+    std::atomic<bool> exhausted{false};
+
+    // 申请 count 个连续节点，不跨分块；超出容量时返回 kNullNode
+    NodeIndex allocate(int count);
+};
+
+#endif
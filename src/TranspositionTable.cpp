@@ -0,0 +1,79 @@
+#include "TranspositionTable.hpp"
+
+void TranspositionTable::resize(size_t mb) {
+    megabytes = mb;
+    size_t count = 0;
+    if (mb > 0) {
+        // 取不超过预算的最大的 2 的幂，取桶下标只要一次与运算
+        count = 1;
+        while (count * 2 * sizeof(Bucket) <= mb * 1024 * 1024) {
+            count *= 2;
+        }
+    }
+    if (count != numBuckets) {
+        buckets.reset(count ? new Bucket[count] : nullptr);
+        numBuckets = count;
+    }
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t b = 0; b < numBuckets; b++) {
+        for (TTEntry& e : buckets[b].entries) {
+            e.key.store(0, std::memory_order_relaxed);
+            e.visits.store(0, std::memory_order_relaxed);
+            e.winsFixed.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool TranspositionTable::probe(uint64_t key, uint32_t& visits, double& wins) const {
+    key = storedKey(key);
+    const Bucket& bucket = bucketFor(key);
+    for (const TTEntry& e : bucket.entries) {
+        if (e.key.load(std::memory_order_relaxed) == key) {
+            visits = e.visits.load(std::memory_order_relaxed);
+            wins = e.winsFixed.load(std::memory_order_relaxed) / TTEntry::kWinScale;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t TranspositionTable::update(uint64_t key, double result) {
+    key = storedKey(key);
+    uint32_t winsFixed = static_cast<uint32_t>(result * TTEntry::kWinScale + 0.5);
+    Bucket& bucket = bucketFor(key);
+
+    // 已经有这一项就直接累加；顺便找出替换对象：优先空项，否则访问数最少的一项
+    TTEntry* victim = nullptr;
+    uint64_t victimKey = 0;
+    uint32_t victimVisits = 0;
+    for (TTEntry& e : bucket.entries) {
+        uint64_t k = e.key.load(std::memory_order_relaxed);
+        if (k == key) {
+            // 快溢出了先减半。不是原子地一起改，和别的线程的累加撞上时丢几次更新，
+            // 离真正溢出还有 800 万次访问的余量，不会因为并发而越过
+            if (e.visits.load(std::memory_order_relaxed) >= TTEntry::kMaxVisits) {
+                e.visits.store(e.visits.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+                e.winsFixed.store(e.winsFixed.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+            }
+            e.winsFixed.fetch_add(winsFixed, std::memory_order_relaxed);
+            return e.visits.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+        uint32_t v = (k == 0) ? 0 : e.visits.load(std::memory_order_relaxed);
+        if (!victim || v < victimVisits) {
+            victim = &e;
+            victimKey = k;
+            victimVisits = v;
+        }
+    }
+
+    // 抢占替换对象；别的线程先动了它就放弃这次记录
+    if (victim->key.compare_exchange_strong(victimKey, key, std::memory_order_relaxed)) {
+        victim->visits.store(1, std::memory_order_relaxed);
+        victim->winsFixed.store(winsFixed, std::memory_order_relaxed);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// 置换表的一项：一个局面（含轮到谁走）累计的访问数和得分。
+// 得分和 MCTSNode 一样，是从走进这个局面的那一方（3 - 轮到谁走）的视角记的
+struct TTEntry {
+    // 得分用定点数存，和访问数一起放进 16 字节。winsFixed 最多 visits × 256，访问数过了 1600 万就会溢出，
+    // 所以访问数到 kMaxVisits 时两者一起减半（平均分不变，相当于让很久以前的访问权重小一些）
+    static constexpr double kWinScale = 256.0;
+    static const uint32_t kMaxVisits = 1u << 23;
+
+    std::atomic<uint64_t> key;       // 局面的 Zobrist 键，0 表示空
+    std::atomic<uint32_t> visits;
+    std::atomic<uint32_t> winsFixed; // 得分 × kWinScale
+};
+
+// 按局面共享 MCTS 统计的置换表。不同走子顺序到达同一局面时，树里是不同的节点，但查到的是同一项。
+// 大小固定（按 MB 配置，取不超过它的 2 的幂个桶），每个桶 4 项正好一条缓存行。
+// 不加锁：各字段是原子量，偶尔两个线程同时替换同一项时丢几次更新，对统计没有实质影响
+class TranspositionTable {
+public:
+    static const int kBucketSize = 4;
+
+    TranspositionTable() = default;
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // 重新分配为最多 megabytes MB 并清空，0 表示关闭置换表。不能和搜索线程同时调用
+    void resize(size_t megabytes);
+    // 清空所有项。不能和搜索线程同时调用
+    void clear();
+    bool enabled() const { return numBuckets != 0; }
+
+    // 查 key 对应局面的统计，没有这一项时返回 false
+    bool probe(uint64_t key, uint32_t& visits, double& wins) const;
+    // 给 key 对应局面记一次访问和得分 result，返回记完之后这个局面的访问数（没记上时返回 0）。
+    // 表里没有这一项时替换桶里访问数最少的一项
+    uint32_t update(uint64_t key, double result);
+
+    size_t sizeMegabytes() const { return megabytes; }
+    size_t memoryBytes() const { return numBuckets * sizeof(Bucket); }
+
+private:
+    struct alignas(64) Bucket {
+        TTEntry entries[kBucketSize];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t numBuckets = 0;
+    size_t megabytes = 0;
+
+    // 0 留给空项，真碰上键为 0 的局面就换成 1
+    static uint64_t storedKey(uint64_t key) { return key ? key : 1; }
+    Bucket& bucketFor(uint64_t key) const { return buckets[key & (numBuckets - 1)]; }
+};
+
+#endif
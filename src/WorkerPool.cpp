@@ -0,0 +1,55 @@
+#include "WorkerPool.hpp"
+
+WorkerPool::WorkerPool(int numThreads) {
+    for (int i = 1; i < numThreads; i++) {
+        threads.emplace_back(&WorkerPool::workerLoop, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+void WorkerPool::run(const std::function<void(int)>& job) {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        currentJob = &job;
+        pending = static_cast<int>(threads.size());
+        generation++;
+    }
+    wakeUp.notify_all();
+
+    job(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+    currentJob = nullptr;
+}
+
+void WorkerPool::workerLoop(int id) {
+    unsigned seen = 0;
+    while (true) {
+        const std::function<void(int)>* job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            job = currentJob;
+        }
+
+        (*job)(id);
+
+        std::lock_guard<std::mutex> guard(mutex);
+        if (--pending == 0) {
+            allDone.notify_one();
+        }
+    }
+}
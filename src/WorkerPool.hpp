@@ -0,0 +1,37 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 常驻的工作线程池：线程只在构造时创建一次，每次 run 把同一个任务交给所有线程并等它们做完。
+// 调用 run 的线程自己也算一个工作线程（编号 0），所以 numThreads = 1 时不会创建任何线程
+class WorkerPool {
+public:
+    explicit WorkerPool(int numThreads);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int size() const { return static_cast<int>(threads.size()) + 1; }
+
+    // 在所有线程上执行 job(线程编号)，全部返回后 run 才返回
+    void run(const std::function<void(int)>& job);
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable allDone;
+    const std::function<void(int)>* currentJob = nullptr;
+    unsigned generation = 0; // 每次 run 加一，线程靠它分辨是不是新任务
+    int pending = 0;         // 还没做完当前任务的后台线程数
+    bool stopping = false;
+
+    void workerLoop(int id);
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <cstdint>
+
+// Zobrist 哈希：每种棋子在每个格子上一个随机 64 位数，局面的哈希是所有棋子对应随机数的异或。
+// 摆上或拿走一个棋子只需异或一次，所以走子时可以增量维护；轮到谁走单独异或一个数
+struct ZobristTable {
+    uint64_t pieces[4][64]; // 按 TileState 编号，EMPTY 那一行全是 0
+    uint64_t side[3];       // 按玩家编号 (1 白 / 2 黑)，side[0] 不用
+
+    constexpr ZobristTable() : pieces(), side() {
+        // splitmix64：固定种子，编译期生成，每次运行、每台机器上都一样
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (int type = 1; type < 4; type++) {
+            for (int sq = 0; sq < 64; sq++) {
+                pieces[type][sq] = next(state);
+            }
+        }
+        side[1] = next(state);
+        side[2] = next(state);
+    }
+
+    static constexpr uint64_t next(uint64_t& state) {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+inline constexpr ZobristTable kZobrist{};
+
+// player 的女王从 from 走到 to、箭射到 arrow 时棋盘哈希的变化量（不含轮到谁走）
+inline uint64_t ZobristMoveDelta(int from, int to, int arrow, int player) {
+    return kZobrist.pieces[player][from] ^ kZobrist.pieces[player][to] ^ kZobrist.pieces[3][arrow];
+}
+
+#endif
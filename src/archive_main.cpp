@@ -0,0 +1,90 @@
+// 扫描对局库（amazons_selfplay --archive 写的文件）：整个文件映射进来，逐盘读动作，不解析、不为每盘分配内存。
+// 输出 JSON：对局数、黑白胜局数、平均步数、每盘第一步的分布里最常见的几个，以及扫描速度。
+//
+// 用法：amazons_archive 文件 [--verify]
+//   --verify    逐盘核对校验和，并在棋盘上重走一遍，检查每步都合法、胜负和终局一致
+#include "Board.hpp"
+#include "MoveGen.hpp"
+#include "GameRecord.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// 在棋盘上重走一盘，每步都必须合法；下完的棋（winner 非 0）轮到的一方必须无路可走
+static bool ReplayIsConsistent(const ArchivedGame& g) {
+    AmazonBoard board;
+    int player = BLACK_QUEEN;
+    for (int i = 0; i < g.plies(); i++) {
+        AmazonMove m = g.move(i).unpack();
+        if (!IsLegalMove(board, player, m)) return false;
+        board.MakeMove(g.move(i), player);
+        player = 3 - player;
+    }
+    return g.winner() == 0 || (!HasAnyMove(board, player) && g.winner() == 3 - player);
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    bool verify = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+        } else if (!path && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            path = nullptr;
+            break;
+        }
+    }
+    if (!path) {
+        std::fprintf(stderr, "usage: %s archive [--verify]\n", argv[0]);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    GameArchive archive;
+    if (!archive.open(path)) {
+        std::fprintf(stderr, "cannot open game archive %s\n", path);
+        return 1;
+    }
+
+    size_t wins[3] = {0, 0, 0};
+    size_t totalPlies = 0, bad = 0;
+    // 第一步按 PackedMove 计数（18 位，直接当下标）
+    std::vector<uint32_t> firstMoves(1u << 18, 0);
+    for (size_t i = 0; i < archive.size(); i++) {
+        ArchivedGame g = archive.game(i);
+        if (!g.valid() || (verify && (!g.verify() || !ReplayIsConsistent(g)))) {
+            bad++;
+            continue;
+        }
+        wins[g.winner() <= 2 ? g.winner() : 0]++;
+        totalPlies += g.plies();
+        if (g.plies() > 0) firstMoves[g.move(0).bits]++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<std::pair<uint32_t, uint32_t>> top;
+    for (uint32_t bits = 0; bits < firstMoves.size(); bits++) {
+        if (firstMoves[bits]) top.emplace_back(firstMoves[bits], bits);
+    }
+    std::sort(top.rbegin(), top.rend());
+    if (top.size() > 5) top.resize(5);
+
+    size_t games = archive.size() - bad;
+    std::printf("{\n  \"games\": %zu,\n  \"bad\": %zu,\n", games, bad);
+    std::printf("  \"black_wins\": %zu,\n  \"white_wins\": %zu,\n  \"unfinished\": %zu,\n", wins[BLACK_QUEEN],
+                wins[WHITE_QUEEN], wins[0]);
+    std::printf("  \"mean_plies\": %.2f,\n  \"first_moves\": [", games ? static_cast<double>(totalPlies) / games : 0.0);
+    for (size_t i = 0; i < top.size(); i++) {
+        AmazonMove m = PackedMove(top[i].second).unpack();
+        std::printf("%s{\"move\": \"%d %d %d %d %d %d\", \"games\": %u}", i ? ", " : "", m.qx1, m.qy1, m.qx2, m.qy2,
+                    m.ax, m.ay, top[i].first);
+    }
+    std::printf("],\n  \"seconds\": %.3f,\n  \"games_per_second\": %.0f\n}\n", seconds,
+                seconds > 0 ? archive.size() / seconds : 0.0);
+    return bad ? 2 : 0;
+}
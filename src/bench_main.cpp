@@ -0,0 +1,312 @@
+// 性能基准：固定的几个局面上跑 perft（走子生成的正确性和速度）、走子生成/评估/模拟的微基准、
+// MCTS 每秒迭代数和 alpha-beta 每秒节点数。随机数都用固定种子，结果以 JSON 输出，方便对比前后版本。
+//
+// 命令行参数：
+//   --quick        减小深度和次数，几秒钟跑完（检查有没有跑坏）
+//   --out 文件     JSON 写到文件里，默认写到标准输出
+//   --simd 级别    scalar|avx2，洪水填充和模拟抽样用的指令集，默认按 CPU 自动选（对比 SIMD 的收益用）
+#include "Board.hpp"
+#include "MoveGen.hpp"
+#include "Evaluation.hpp"
+#include "MCTS.hpp"
+#include "AlphaBeta.hpp"
+#include "RolloutBatch.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 基准局面：8 行字符串，'.' 空格，'W' 白后，'B' 黑后，'x' 箭
+struct BenchPosition {
+    const char* name;
+    int playerToMove;
+    const char* rows[8];
+    // perft 的期望叶子数，下标是深度（从 1 开始），0 表示不跑这个深度
+    uint64_t expected[5];
+};
+
+const BenchPosition kPositions[] = {
+    {"opening", BLACK_QUEEN,
+     {"..B..B..",
+      "........",
+      "B......B",
+      "........",
+      "........",
+      "W......W",
+      "........",
+      "..W..W.."},
+     {0, 1232, 1331198, 1358441750, 0}},
+    // 自对弈第 10 步后，双方还在争中央
+    {"midgame", BLACK_QUEEN,
+     {".....W..",
+      "..B..x..",
+      ".......B",
+      "...B...x",
+      ".x.Wxxx.",
+      "W.x.W...",
+      "..x.....",
+      ".Bxx...."},
+     {0, 501, 185750, 67138026, 0}},
+    // 自对弈第 28 步后，棋盘已经被箭切碎，但双方还没完全分开
+    {"endgame", BLACK_QUEEN,
+     {"x.W.xxx.",
+      ".Bx.xx..",
+      "x.xxBx..",
+      "B.xxWxxx",
+      ".xxxxxxB",
+      "..xW..xx",
+      "..x..W..",
+      "..xx...."},
+     {0, 48, 4556, 162150, 10592706}},
+};
+
+AmazonBoard MakeBoard(const BenchPosition& pos) {
+    AmazonBoard board;
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            char c = pos.rows[y][x];
+            board.SetPiece(x, y, c == 'W' ? WHITE_QUEEN : c == 'B' ? BLACK_QUEEN : c == 'x' ? ARROW : EMPTY);
+        }
+    }
+    return board;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string MoveString(const AmazonMove& m) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%d %d %d %d %d %d", m.qx1, m.qy1, m.qx2, m.qy2, m.ax, m.ay);
+    return buf;
+}
+
+// 走 depth 层后的叶子数。最后一层只数动作不走（批量计数），无子可走的一方在更深的层数上贡献 0
+uint64_t Perft(AmazonBoard& board, int player, int depth, std::vector<MoveList>& lists) {
+    if (depth == 1) return static_cast<uint64_t>(CountMoves(board, player));
+    MoveList& moves = lists[depth];
+    GenerateMoves(board, player, moves);
+    uint64_t total = 0;
+    for (const AmazonMove& m : moves) {
+        board.MakeMove(m, player);
+        total += Perft(board, 3 - player, depth - 1, lists);
+        board.UnmakeMove(m, player);
+    }
+    return total;
+}
+
+// 手写的 JSON 输出：对象和数组按顺序写，逗号自动补
+class JsonWriter {
+public:
+    explicit JsonWriter(FILE* f) : out(f) {}
+    void beginObject(const char* key = nullptr) { open(key, '{'); }
+    void endObject() { close('}'); }
+    void beginArray(const char* key) { open(key, '['); }
+    void endArray() { close(']'); }
+    void field(const char* key, const std::string& v) { prefix(key); std::fprintf(out, "\"%s\"", v.c_str()); }
+    void field(const char* key, const char* v) { field(key, std::string(v)); }
+    void field(const char* key, double v) { prefix(key); std::fprintf(out, "%.6g", v); }
+    void field(const char* key, uint64_t v) { prefix(key); std::fprintf(out, "%llu", static_cast<unsigned long long>(v)); }
+    void field(const char* key, int v) { prefix(key); std::fprintf(out, "%d", v); }
+    void field(const char* key, bool v) { prefix(key); std::fprintf(out, v ? "true" : "false"); }
+
+private:
+    FILE* out;
+    std::vector<bool> first{true};
+
+    void prefix(const char* key) {
+        if (!first.back()) std::fprintf(out, ",");
+        first.back() = false;
+        std::fprintf(out, "\n%*s", static_cast<int>(first.size() - 1) * 2, "");
+        if (key) std::fprintf(out, "\"%s\": ", key);
+    }
+    void open(const char* key, char bracket) {
+        if (first.size() > 1 || key) prefix(key);
+        std::fprintf(out, "%c", bracket);
+        first.push_back(true);
+    }
+    void close(char bracket) {
+        first.pop_back();
+        std::fprintf(out, "\n%*s%c", static_cast<int>(first.size() - 1) * 2, "", bracket);
+        if (first.size() == 1) std::fprintf(out, "\n");
+    }
+};
+
+// 同一个操作反复调用 calls 次，sink 防止结果被优化掉
+template <typename Op>
+void Micro(JsonWriter& json, const char* name, const char* position, long calls, Op op) {
+    uint64_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < calls; i++) {
+        sink += op();
+    }
+    double seconds = SecondsSince(start);
+    json.beginObject();
+    json.field("name", name);
+    json.field("position", position);
+    json.field("calls", static_cast<uint64_t>(calls));
+    json.field("seconds", seconds);
+    json.field("ns_per_call", seconds * 1e9 / calls);
+    json.field("checksum", sink);
+    json.endObject();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    const char* outPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--simd") == 0 && i + 1 < argc) {
+            ++i;
+            SetSimdLevel(std::strcmp(argv[i], "scalar") == 0 ? SIMD_SCALAR : SIMD_AVX2);
+        } else {
+            std::fprintf(stderr, "usage: %s [--quick] [--out file.json] [--simd scalar|avx2]\n", argv[0]);
+            return 1;
+        }
+    }
+    FILE* out = outPath ? std::fopen(outPath, "w") : stdout;
+    if (!out) {
+        std::perror(outPath);
+        return 1;
+    }
+
+    const uint32_t kSeed = 12345;
+    const long scale = quick ? 1 : 10;
+    bool allOk = true;
+    JsonWriter json(out);
+    json.beginObject();
+    json.field("quick", quick);
+    json.field("seed", static_cast<int>(kSeed));
+    json.field("simd", SimdLevelName(ActiveSimdLevel()));
+
+    // 1. perft：叶子数对不上说明走子生成坏了
+    json.beginArray("perft");
+    for (const BenchPosition& pos : kPositions) {
+        for (int depth = 1; depth <= 4; depth++) {
+            if (pos.expected[depth] == 0 || (quick && depth > 1 && pos.expected[depth] > 1000000)) continue;
+            AmazonBoard board = MakeBoard(pos);
+            std::vector<MoveList> lists(depth + 1);
+            auto start = std::chrono::steady_clock::now();
+            uint64_t nodes = Perft(board, pos.playerToMove, depth, lists);
+            double seconds = SecondsSince(start);
+            bool ok = nodes == pos.expected[depth];
+            allOk = allOk && ok;
+            json.beginObject();
+            json.field("position", pos.name);
+            json.field("depth", depth);
+            json.field("nodes", nodes);
+            json.field("expected", pos.expected[depth]);
+            json.field("ok", ok);
+            json.field("seconds", seconds);
+            json.field("nodes_per_second", nodes / std::max(seconds, 1e-9));
+            json.endObject();
+        }
+    }
+    json.endArray();
+
+    // 2. 微基准
+    json.beginArray("micro");
+    for (const BenchPosition& pos : kPositions) {
+        AmazonBoard board = MakeBoard(pos);
+        int player = pos.playerToMove;
+        static MoveList list;
+        Micro(json, "generate_moves", pos.name, 2000 * scale, [&] { return static_cast<uint64_t>(GenerateMoves(board, player, list)); });
+        Micro(json, "count_moves", pos.name, 5000 * scale, [&] { return static_cast<uint64_t>(CountMoves(board, player)); });
+        Micro(json, "evaluate_territory", pos.name, 20000 * scale,
+              [&] { return static_cast<uint64_t>(EvaluateTerritory(board, player, player) * 1e6); });
+        Micro(json, "evaluate_mobility", pos.name, 5000 * scale,
+              [&] { return static_cast<uint64_t>(EvaluateMobility(board, player) * 1e6); });
+        // 从这个局面随机下到终局
+        std::mt19937 rng(kSeed);
+        Micro(json, "rollout", pos.name, 200 * scale, [&] {
+            AmazonBoard b = board;
+            int p = player;
+            uint64_t plies = 0;
+            AmazonMove m;
+            while (SampleRandomMove(b, p, rng, m)) {
+                b.MakeMove(m, p);
+                p = 3 - p;
+                plies++;
+            }
+            return plies;
+        });
+        // MCTS 模拟阶段的实际工作量：16 个叶子各随机走 4 步再一起评估
+        static RolloutBatch batch;
+        RolloutSettings settings;
+        settings.endgameSolver = false;
+        Micro(json, "rollout_batch16", pos.name, 200 * scale, [&] {
+            batch.clear();
+            for (int i = 0; i < 16; i++) batch.add(board, player);
+            batch.run(settings, player, rng);
+            double sum = 0.0;
+            for (int i = 0; i < 16; i++) sum += batch.result(i);
+            return static_cast<uint64_t>(sum * 1e6);
+        });
+    }
+    json.endArray();
+
+    // 3. 搜索吞吐：单线程、固定种子、按迭代次数/节点数，结果可复现
+    json.beginArray("search");
+    for (const BenchPosition& pos : kPositions) {
+        AmazonBoard board = MakeBoard(pos);
+        {
+            MCTS mcts;
+            mcts.config.seed = kSeed;
+            mcts.config.endgameSolver = false; // 只量 MCTS 本身
+            int iterations = static_cast<int>(2000 * scale);
+            auto start = std::chrono::steady_clock::now();
+            AmazonMove best = mcts.GetBestMove(board, pos.playerToMove, iterations);
+            double seconds = SecondsSince(start);
+            json.beginObject();
+            json.field("engine", mcts.Name());
+            json.field("position", pos.name);
+            json.field("iterations", iterations);
+            json.field("tree_nodes", static_cast<uint64_t>(mcts.TreeNodeCount()));
+            json.field("seconds", seconds);
+            json.field("playouts_per_second", iterations / std::max(seconds, 1e-9));
+            json.field("best_move", MoveString(best));
+            SearchStats stats = mcts.GetSearchStats(0);
+            json.field("max_depth", stats.maxDepth);
+            // 用 -DAMAZONS_SEARCH_PROFILE=ON 编译时才有各阶段用时
+            if (stats.phasesTimed) {
+                json.beginObject("phase_seconds");
+                for (int p = 0; p < kNumSearchPhases; p++) json.field(SearchPhaseName(p), stats.phaseSeconds[p]);
+                json.endObject();
+            }
+            json.endObject();
+        }
+        {
+            AlphaBeta ab;
+            ab.config.endgameSolver = false;
+            SearchLimits limits;
+            limits.iterations = static_cast<int>(20000 * scale);
+            auto start = std::chrono::steady_clock::now();
+            AmazonMove best = ab.GetBestMove(board, pos.playerToMove, limits);
+            double seconds = SecondsSince(start);
+            json.beginObject();
+            json.field("engine", ab.Name());
+            json.field("position", pos.name);
+            json.field("nodes", static_cast<uint64_t>(ab.NodesSearched()));
+            json.field("depth", ab.CompletedDepth());
+            json.field("seconds", seconds);
+            json.field("nodes_per_second", ab.NodesSearched() / std::max(seconds, 1e-9));
+            json.field("best_move", MoveString(best));
+            json.endObject();
+        }
+    }
+    json.endArray();
+
+    json.field("perft_ok", allOk);
+    json.endObject();
+    if (outPath) std::fclose(out);
+    return allOk ? 0 : 2;
+}
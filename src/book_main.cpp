@@ -0,0 +1,106 @@
+// 离线建开局库：从初始局面开始，每个局面用长时间的 MCTS 搜索选出推荐动作记进库里，
+// 再沿访问数最多的前几个动作往下展开（对手可能走的几种应对都要有），直到指定步数。
+// 对称的局面只搜一次（库按对称折叠后的键存），结果写成 OpeningBook 能直接映射的文件。
+//
+// 命令行参数：
+//   --out 文件          输出文件，默认 opening_book.bin
+//   --depth 步数        从初始局面往下建几步，默认 4
+//   --branch K          每个局面往下展开访问数前 K 的动作，默认 3
+//   --iterations N      每个局面搜索的迭代次数，默认 200000
+//   --threads T         搜索线程数，默认用上所有硬件线程
+#include "Board.hpp"
+#include "MoveGen.hpp"
+#include "MCTS.hpp"
+#include "OpeningBook.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+struct BookBuildOptions {
+    std::string outPath = "opening_book.bin";
+    int depth = 4;
+    int branch = 3;
+    int iterations = 200000;
+    int threads = 0;
+};
+
+class BookBuilder {
+public:
+    explicit BookBuilder(const BookBuildOptions& o) : options(o) {
+        engine.config.numThreads = o.threads;
+        // 开局还分不开，残局求解用不上
+        engine.config.endgameSolver = false;
+    }
+
+    void expand(const AmazonBoard& board, int player, int depth) {
+        if (depth == 0 || !HasAnyMove(board, player) || book.contains(board, player)) return;
+
+        auto start = std::chrono::steady_clock::now();
+        engine.ResetTree();
+        engine.GetBestMove(board, player, options.iterations);
+        std::vector<RootChildStats> children = engine.RootChildren();
+        if (children.empty()) return;
+        const RootChildStats& best = children[0];
+        book.add(board, player, best.move, best.visits, best.winRate);
+        searches++;
+        std::fprintf(stderr, "[%zu] depth %d: %d %d %d %d %d %d  visits %u  win %.3f  (%.1fs)\n", book.size(),
+                     options.depth - depth, best.move.qx1, best.move.qy1, best.move.qx2, best.move.qy2, best.move.ax,
+                     best.move.ay, best.visits, best.winRate,
+                     std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        int branches = std::min<int>(options.branch, static_cast<int>(children.size()));
+        for (int i = 0; i < branches; i++) {
+            AmazonBoard next = board;
+            next.MakeMove(children[i].move, player);
+            expand(next, 3 - player, depth - 1);
+        }
+    }
+
+    bool write() const { return book.write(options.outPath); }
+    size_t size() const { return book.size(); }
+    int searchCount() const { return searches; }
+
+private:
+    BookBuildOptions options;
+    MCTS engine;
+    OpeningBookBuilder book;
+    int searches = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BookBuildOptions options;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            options.outPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--depth") == 0 && hasValue) {
+            options.depth = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--branch") == 0 && hasValue) {
+            options.branch = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--iterations") == 0 && hasValue) {
+            options.iterations = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--out file] [--depth plies] [--branch K] [--iterations N] [--threads T]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    BookBuilder builder(options);
+    builder.expand(AmazonBoard(), BLACK_QUEEN, options.depth); // 黑方先走
+    if (!builder.write()) {
+        std::perror(options.outPath.c_str());
+        return 1;
+    }
+    std::fprintf(stderr, "%zu positions from %d searches written to %s\n", builder.size(), builder.searchCount(),
+                 options.outPath.c_str());
+    return 0;
+}
@@ -0,0 +1,145 @@
+// Botzone 控制台程序：简单交互格式，不依赖 raylib，可以在没有图形界面的服务器上跑。
+//
+// 第一回合的输入：第一行是回合数 n，接下来 2n-1 行依次是收到的 request 和自己之前的 response，
+// 每行 6 个整数 x0 y0 x1 y1 x2 y2（女王从 (x0,y0) 走到 (x1,y1)，箭射到 (x2,y2)）。
+// 第一个 request 全是 -1 表示我们先手执黑（黑方先走）。输出一行 6 个整数，无路可走时输出 6 个 -1。
+// 长时运行模式下每回合输出后再输出 >>>BOTZONE_REQUEST_KEEP_RUNNING<<<，进程不退出，
+// 之后每回合只读一行新的 request。这样搜索树、置换表和残局记忆表都跨回合保留，不用每回合重建。
+//
+// 命令行参数：
+//   --engine mcts|ab    搜索引擎，默认 mcts
+//   --time 秒           每步思考时间，默认 0.9
+//   --once              不进入长时运行模式，答完一回合就退出
+//   --book 文件         开局库（amazons_book 生成），库里有的局面直接按库走
+#include "Board.hpp"
+#include "MCTS.hpp"
+#include "AlphaBeta.hpp"
+#include "OpeningBook.hpp"
+#include "SearchEngine.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+static const char* kKeepRunning = ">>>BOTZONE_REQUEST_KEEP_RUNNING<<<";
+
+// 读一行动作，读不到（输入结束）时返回 false。AmazonMove 的坐标是 int8_t，
+// 直接 >> 会按字符读，所以先读成 int；越界的坐标换成 8，后面的合法性检查会拒掉
+static bool ReadMove(AmazonMove& m) {
+    int v[6];
+    for (int& c : v) {
+        if (!(std::cin >> c)) return false;
+        if (c < -1 || c > 7) c = 8;
+    }
+    m = AmazonMove(v[0], v[1], v[2], v[3], v[4], v[5]);
+    return true;
+}
+
+static bool IsPass(const AmazonMove& m) {
+    return m.qx1 < 0;
+}
+
+// 在棋盘上走一步，并告诉引擎，让它保留这一步之后还有用的搜索结果
+static void PlayMove(AmazonBoard& board, SearchEngine& bot, const AmazonMove& m, int player) {
+    board.MakeMove(m, player);
+    bot.AdvanceRoot(m);
+}
+
+static std::unique_ptr<SearchEngine> CreateBot(EngineType type) {
+    std::unique_ptr<SearchEngine> bot = CreateEngine(type);
+    // Botzone 只给一个核、256MB 内存。残局阶段搜索树已经分配的分块不会还回去，
+    // 所以残局记忆表要和树、置换表一起算进预算：MCTS 128 + 32 + 24（模拟用的另有 6），alpha-beta 64 + 24
+    if (MCTS* mcts = dynamic_cast<MCTS*>(bot.get())) {
+        mcts->config.numThreads = 1;
+        mcts->config.treeMemoryMB = 128;
+        mcts->config.transpositionTableMB = 32;
+        mcts->config.endgameMemoryMB = 24;
+    } else if (AlphaBeta* ab = dynamic_cast<AlphaBeta*>(bot.get())) {
+        ab->config.hashMB = 64;
+        ab->config.endgameMemoryMB = 24;
+    }
+    return bot;
+}
+
+int main(int argc, char** argv) {
+    EngineType engineType = ENGINE_MCTS;
+    SearchLimits limits;
+    limits.iterations = 0;
+    limits.timeLimitSeconds = 0.9;
+    bool keepRunning = true;
+    const char* bookPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            engineType = std::strcmp(argv[++i], "ab") == 0 ? ENGINE_ALPHABETA : ENGINE_MCTS;
+        } else if (std::strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            limits.timeLimitSeconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--once") == 0) {
+            keepRunning = false;
+        } else if (std::strcmp(argv[i], "--book") == 0 && i + 1 < argc) {
+            bookPath = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--engine mcts|ab] [--time seconds] [--once] [--book file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::unique_ptr<SearchEngine> bot = CreateBot(engineType);
+    if (bookPath) {
+        std::shared_ptr<OpeningBook> book = std::make_shared<OpeningBook>();
+        // 打不开就不用库，照常搜索
+        if (book->open(bookPath)) {
+            bot->SetOpeningBook(book);
+        } else {
+            std::fprintf(stderr, "cannot open opening book %s\n", bookPath);
+        }
+    }
+    AmazonBoard board;
+
+    // 第一回合：按历史把棋盘摆出来。request 是对方的动作，response 是我们的
+    int turns = 0;
+    if (!(std::cin >> turns) || turns <= 0) return 1;
+    int me = BLACK_QUEEN;
+    for (int i = 0; i < 2 * turns - 1; i++) {
+        AmazonMove m;
+        if (!ReadMove(m)) return 1;
+        bool request = (i % 2 == 0);
+        if (i == 0 && request) {
+            me = IsPass(m) ? BLACK_QUEEN : WHITE_QUEEN;
+        }
+        if (IsPass(m)) continue;
+        int player = request ? 3 - me : me;
+        if (!IsLegalMove(board, player, m)) {
+            std::fprintf(stderr, "illegal move in history: %d %d %d %d %d %d\n", m.qx1, m.qy1, m.qx2, m.qy2, m.ax, m.ay);
+            return 1;
+        }
+        PlayMove(board, *bot, m, player);
+    }
+
+    while (true) {
+        AmazonMove best{-1, -1, -1, -1, -1, -1};
+        if (HasAnyMove(board, me)) {
+            best = bot->GetBestMove(board, me, limits);
+            PlayMove(board, *bot, best, me);
+        }
+        std::cout << int(best.qx1) << ' ' << int(best.qy1) << ' ' << int(best.qx2) << ' ' << int(best.qy2) << ' '
+                  << int(best.ax) << ' ' << int(best.ay) << '\n';
+        if (!keepRunning) {
+            std::cout.flush();
+            return 0;
+        }
+        std::cout << kKeepRunning << std::endl;
+
+        // 长时运行：之后每回合只给对方的新动作
+        AmazonMove reply;
+        if (!ReadMove(reply)) return 0;
+        if (IsPass(reply)) continue;
+        if (!IsLegalMove(board, 3 - me, reply)) {
+            std::fprintf(stderr, "illegal request: %d %d %d %d %d %d\n", reply.qx1, reply.qy1, reply.qx2, reply.qy2, reply.ax, reply.ay);
+            return 1;
+        }
+        PlayMove(board, *bot, reply, 3 - me);
+    }
+}
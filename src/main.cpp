@@ -3,27 +3,47 @@
 #include <ctime>
 #include "MCTS.hpp"
 #include <string>
+#include <thread>
+#include <algorithm>
+#include <memory>
 #include "GameManager.hpp"
+#include "OpeningBook.hpp"
 const int screenWidth = 800;
 const int screenHeight = 800;
 const int gridSize = 8; // 棋盘大小为8x8
 const int cellSize = screenWidth / gridSize;
 
-MCTS myCleverBot;
+// bot 用的搜索引擎，菜单里按 [E] 在 MCTS 和 alpha-beta 之间切换
+EngineType botEngine = ENGINE_MCTS;
+std::unique_ptr<SearchEngine> myCleverBot;
+// 程序目录下有 opening_book.bin（amazons_book 生成）就在开局时按库走，两种引擎共用
+std::shared_ptr<OpeningBook> openingBook;
+
+std::unique_ptr<SearchEngine> CreateBot(EngineType type) {
+    std::unique_ptr<SearchEngine> bot = CreateEngine(type);
+    if (openingBook && openingBook->isOpen()) {
+        bot->SetOpeningBook(openingBook);
+    }
+    // MCTS 可以多线程，留一个核给绘制
+    if (MCTS* mcts = dynamic_cast<MCTS*>(bot.get())) {
+        mcts->config.numThreads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    }
+    return bot;
+}
 
 GameManager gm;
 
 void InitAmazons() {
-    gm.board.grid[0][2] = 2; gm.board.grid[0][5] = 2; // 黑方
-    gm.board.grid[2][0] = 2; gm.board.grid[2][7] = 2; // 黑方
-    gm.board.grid[7][2] = 1; gm.board.grid[7][5] = 1; // 白方
-    gm.board.grid[5][0] = 1; gm.board.grid[5][7] = 1; // 白方
+    gm.board.SetPiece(2, 0, 2); gm.board.SetPiece(5, 0, 2); // 黑方
+    gm.board.SetPiece(0, 2, 2); gm.board.SetPiece(7, 2, 2); // 黑方
+    gm.board.SetPiece(2, 7, 1); gm.board.SetPiece(5, 7, 1); // 白方
+    gm.board.SetPiece(0, 5, 1); gm.board.SetPiece(7, 5, 1); // 白方
 }
 
 void boardClear(){
     for(int i=0;i<8;i++){
         for(int j=0;j<8;j++){
-            gm.board.grid[i][j] = EMPTY;
+            gm.board.SetPiece(j, i, EMPTY);
         }
     }
 }
@@ -57,9 +77,9 @@ void DrawBoardScene(bool isOver) {
                 else if (isHighlit) DrawRectangle(x * cellSize, y * cellSize, cellSize, cellSize, LIME);
             }
 
-            if (gm.board.grid[y][x] == 1) DrawCircle(x*cellSize + cellSize/2, y*cellSize + cellSize/2, cellSize*0.4, WHITE);
-            if (gm.board.grid[y][x] == 2) DrawCircle(x*cellSize + cellSize/2, y*cellSize + cellSize/2, cellSize*0.4, BLACK);
-            if (gm.board.grid[y][x] == 3) DrawPoly({(float)x*cellSize + cellSize/2, (float)y*cellSize + cellSize/2}, 4, cellSize*0.3, 45, RED);
+            if (gm.board.GetPiece(x, y) == 1) DrawCircle(x*cellSize + cellSize/2, y*cellSize + cellSize/2, cellSize*0.4, WHITE);
+            if (gm.board.GetPiece(x, y) == 2) DrawCircle(x*cellSize + cellSize/2, y*cellSize + cellSize/2, cellSize*0.4, BLACK);
+            if (gm.board.GetPiece(x, y) == 3) DrawPoly({(float)x*cellSize + cellSize/2, (float)y*cellSize + cellSize/2}, 4, cellSize*0.3, 45, RED);
         }
     }
 }
@@ -72,20 +92,58 @@ int main() {
     InitAmazons();
     SetTargetFPS(60);
     bool needToCheckGameOver = true;
+    // 玩家的一步要跨好几帧（选子、移动、射箭）才拼完整，所以放在循环外面
+    AmazonMove humanMove = {0, 0, 0, 0, 0, 0};
+
+    // bot 在后台线程按时间思考，界面每帧照常刷新
+    openingBook = std::make_shared<OpeningBook>();
+    openingBook->open("opening_book.bin");
+    myCleverBot = CreateBot(botEngine);
+    gm.engineName = myCleverBot->Name();
+    SearchLimits botLimits;
+    botLimits.iterations = 0;
+    botLimits.timeLimitSeconds = 2.0;
+    bool botThinking = false;
+    AmazonBoard botSearchBoard; // bot 开始思考时的局面，结果回来时局面变了（复盘、读档）就作废
+    bool ponderStarted = false; // 这个玩家回合是否已经开始后台思考
 
     while (!WindowShouldClose()) {
-        AmazonMove humanMove;
         if(IsKeyPressed(KEY_TAB)) gm.currentScene = MENU;
         if (gm.currentScene == MENU) {
-            if (IsKeyPressed(KEY_N)) gm.StartNewGame(); gm.history.clear();
-            if (IsKeyPressed(KEY_L)) gm.LoadGame("save.dat");
-        }else if(gm.currentScene == REPLAY){
-            if(IsMouseButtonPressed(MOUSE_BUTTON_LEFT)){
-                gm.NextReplayStep();
+            if (IsKeyPressed(KEY_E)) {
+                // 换引擎：旧引擎析构时会停掉它的后台搜索，新引擎下一帧按当前局面重新开始
+                botEngine = (botEngine == ENGINE_MCTS) ? ENGINE_ALPHABETA : ENGINE_MCTS;
+                myCleverBot = CreateBot(botEngine);
+                gm.engineName = myCleverBot->Name();
+                botThinking = false;
+                ponderStarted = false;
+            }
+            if (IsKeyPressed(KEY_N)) {
+                myCleverBot->StopSearch();
+                botThinking = false;
+                ponderStarted = false;
+                gm.StartNewGame();
+                currentPlayer = gm.currentPlayer;
+                gameState = 0;
+                gameover = false;
+                needToCheckGameOver = true;
+            }
+            gm.history.clear();
+            if (IsKeyPressed(KEY_L) && gm.LoadGame("save.dat")) {
+                myCleverBot->StopSearch();
+                botThinking = false;
+                ponderStarted = false;
+                currentPlayer = gm.currentPlayer;
+                gameState = 0;
+                gameover = false;
+                needToCheckGameOver = true;
             }
-            if(IsKeyPressed(KEY_R)) gm.currentScene = PLAYING;
+        }else if(gm.currentScene == REPLAY){
+            gm.HandleReplayInput();
+            if(IsKeyPressed(KEY_R)) gm.currentScene = PLAYING; // 复盘不动 gm.board，回去接着下
         }else if(gm.currentScene == PLAYING){
-            if (IsKeyPressed(KEY_S)) {
+            // 玩家一步走到一半（已经挪了女王还没射箭）时不存，存档里的局面总是和历史对得上
+            if (IsKeyPressed(KEY_S) && gameState == 0) {
                 if(gm.SaveGame("save.dat")){
                     displaySaveMessageUntil = GetTime() + 2.0f;
                 }
@@ -98,8 +156,7 @@ int main() {
 
             // checkpoint；检测游戏是否已经结束
             if(!gameover&&needToCheckGameOver){
-                std::vector<AmazonMove> nextMoves = myCleverBot.getAllLegalMoves(gm.board,currentPlayer);
-                if(nextMoves.empty()){
+                if(!HasAnyMove(gm.board,currentPlayer)){
                     gameover = 1;
                 }
                 needToCheckGameOver = false;
@@ -107,16 +164,31 @@ int main() {
             if(!gameover){  
                 // 人机回合！
                 if(currentPlayer == 1){
-
-                    AmazonMove botMove = myCleverBot.GetBestMove(gm.board,currentPlayer);
-                    gm.history.push_back(botMove);//便于复盘
-                    gm.board.SetPiece(botMove.qx1,botMove.qy1,EMPTY);
-                    gm.board.SetPiece(botMove.qx2,botMove.qy2,currentPlayer);
-                    gm.board.SetPiece(botMove.ax,botMove.ay,ARROW);
-                    currentPlayer = 2;
-                    gameState = 0;
-                    gm.turn++;
-                    needToCheckGameOver = true;
+                    if(!botThinking){
+                        // 开始后台思考，这一帧照常绘制 "BOT THINKING..."
+                        botSearchBoard = gm.board;
+                        myCleverBot->StartSearch(gm.board,currentPlayer,botLimits);
+                        botThinking = true;
+                    }
+                    else if(!myCleverBot->IsSearching()){
+                        AmazonMove botMove = myCleverBot->WaitForResult();
+                        botThinking = false;
+                        if(gm.board == botSearchBoard){ // 局面没变才落子，否则下一帧按新局面重新思考
+                            gm.history.push_back(botMove);//便于复盘
+                            myCleverBot->AdvanceRoot(botMove);//搜索树保留这一步下面的分支，下回合接着用
+                            gm.board.MakeMove(botMove,currentPlayer);
+                            currentPlayer = 2;
+                            gameState = 0;
+                            gm.turn++;
+                            needToCheckGameOver = true;
+                        }
+                    }
+                }
+                // 玩家回合 bot 也不闲着：在玩家落子前的局面上后台思考，玩家走完后保留对应的子树
+                // 只在选子阶段开始，此时玩家还没动棋盘
+                if (currentPlayer == 2 && gameState == 0 && !ponderStarted) {
+                    myCleverBot->StartPondering(gm.board, currentPlayer);
+                    ponderStarted = true;
                 }
                 // ore no turn!
                 if (currentPlayer == 2&&IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
@@ -126,7 +198,7 @@ int main() {
                     int y = mPos.y / cellSize;
 
                     if (gameState == 0) { // 选子阶段
-                        if (gm.board.grid[y][x] == currentPlayer) {
+                        if (gm.board.GetPiece(x, y) == currentPlayer) {
                             selectedIdx = {(float)x, (float)y};
                             humanMove.qx1 = selectedIdx.x;
                             humanMove.qy1 = selectedIdx.y;
@@ -144,8 +216,8 @@ int main() {
 
                         // 使用写好的 IsPathClear 进行合法性判定
                         else if (gm.board.IsPathClear((int)selectedIdx.x, (int)selectedIdx.y, x, y)) {
-                            gm.board.grid[(int)selectedIdx.y][(int)selectedIdx.x] = EMPTY;
-                            gm.board.grid[y][x] = currentPlayer;
+                            gm.board.SetPiece((int)selectedIdx.x, (int)selectedIdx.y, EMPTY);
+                            gm.board.SetPiece(x, y, currentPlayer);
                             selectedIdx = {(float)x, (float)y}; 
                             humanMove.qx2 = selectedIdx.x;
                             humanMove.qy2 = selectedIdx.y;
@@ -155,10 +227,12 @@ int main() {
                     // 在射箭阶段 (gameState == 2)
                     else if (gameState == 2) { 
                         if (gm.board.IsPathClear((int)selectedIdx.x, (int)selectedIdx.y, x, y)) {
-                            gm.board.grid[y][x] = ARROW;
+                            gm.board.SetPiece(x, y, ARROW);
                             humanMove.ax = x;
                             humanMove.ay = y;
                             gm.RecordMove(humanMove); 
+                            myCleverBot->AdvanceRoot(humanMove);//停掉后台思考，树根推进到玩家这一步
+                            ponderStarted = false;
                             currentPlayer = 1; 
                             gameState = 0;
                             selectedIdx = {-1.-1};
@@ -169,6 +243,9 @@ int main() {
             }
             else {
                 if(IsKeyPressed(KEY_SPACE)){
+                    myCleverBot->StopSearch();
+                    botThinking = false;
+                    ponderStarted = false;
                     gameover = false;
                     boardClear();
                     InitAmazons();
@@ -187,7 +264,11 @@ int main() {
         }
         //现在绘制界面
 
+        if (IsKeyPressed(KEY_F3)) gm.showStats = !gm.showStats;
+        if (gm.showStats) gm.searchStats = myCleverBot->GetSearchStats(5); // 思考中每帧刷新
+
         BeginDrawing();
+        gm.currentPlayer = currentPlayer; // 让状态栏知道现在轮到谁（bot 思考时显示 BOT THINKING...）
         gm.Draw(gameState,selectedIdx,gameover);//注意Draw函数内部是没有begin和end的
         if(GetTime()<displaySaveMessageUntil){
             DrawRectangle(250,350,300,50,Fade(DARKGRAY,0.8f));
@@ -195,6 +276,7 @@ int main() {
         }
         EndDrawing();
     }
+    myCleverBot->StopSearch();
     CloseWindow();
     return 0;
 }
\ No newline at end of file
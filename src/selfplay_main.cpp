@@ -0,0 +1,373 @@
+// 无界面的自对弈比赛：两套引擎配置 A、B 在多个核上同时下很多盘，报告 A 的胜率、置信区间和 Elo 差，
+// 可以用 SPRT 提前结束，所有对局写成 JSON Lines 留着以后分析；--archive 另外追加进二进制对局库（GameRecord.hpp），
+// 几百万盘也能直接映射进来扫。
+//
+// 每个开局（随机走 --opening-plies 步）下两盘，A 先执黑再执白，抵消先手优势和开局的偶然性。
+// 每盘棋各自新建两个单线程引擎，同时进行的对局数由 --concurrency 控制。
+//
+// 引擎配置是逗号分隔的 key=value，例如
+//   --a "engine=mcts,iterations=5000,c=2.0,eval=territory" --b "engine=mcts,time=0.2,selection=ucb1"
+// 通用：engine=mcts|ab  iterations=N  time=秒  eval=territory|mobility  endgame=0|1  book=开局库文件
+// MCTS：selection=ucb1|widening|puct  c=UCB1 系数  puct=PUCT 系数  temp=先验温度  rollout=模拟步数  batch=每批模拟的叶子数
+//       widen=渐进展开系数  tt=置换表MB  tree=搜索树MB
+// alpha-beta：depth=最大深度  hash=置换表MB
+#include "Board.hpp"
+#include "MoveGen.hpp"
+#include "MCTS.hpp"
+#include "AlphaBeta.hpp"
+#include "OpeningBook.hpp"
+#include "GameRecord.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct PlayerSpec {
+    std::string text;         // 原样保留，输出里标注是哪套配置
+    EngineType engine = ENGINE_MCTS;
+    SearchLimits limits;
+    MCTSConfig mcts;
+    AlphaBetaConfig alphaBeta;
+    std::shared_ptr<const OpeningBook> book; // 所有对局共用一份映射
+};
+
+bool ParseSpec(const std::string& text, PlayerSpec& spec) {
+    spec.text = text;
+    spec.mcts.numThreads = 1;
+    // 同时有很多引擎在跑，默认表小一些
+    spec.mcts.transpositionTableMB = 16;
+    spec.mcts.treeMemoryMB = 256;
+    spec.alphaBeta.hashMB = 16;
+
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            std::fprintf(stderr, "bad option '%s' (expected key=value)\n", item.c_str());
+            return false;
+        }
+        std::string key = item.substr(0, eq);
+        std::string value = item.substr(eq + 1);
+        double number = std::atof(value.c_str());
+        if (key == "engine") {
+            if (value == "mcts") spec.engine = ENGINE_MCTS;
+            else if (value == "ab") spec.engine = ENGINE_ALPHABETA;
+            else return false;
+        } else if (key == "iterations") {
+            spec.limits.iterations = static_cast<int>(number);
+        } else if (key == "time") {
+            spec.limits.timeLimitSeconds = number;
+        } else if (key == "eval") {
+            LeafEvaluation eval = value == "mobility" ? EVAL_MOBILITY : EVAL_TERRITORY;
+            spec.mcts.leafEvaluation = eval;
+            spec.alphaBeta.leafEvaluation = eval;
+        } else if (key == "endgame") {
+            spec.mcts.endgameSolver = number != 0;
+            spec.alphaBeta.endgameSolver = number != 0;
+        } else if (key == "selection") {
+            if (value == "ucb1") spec.mcts.selection = SELECT_UCB1;
+            else if (value == "widening") spec.mcts.selection = SELECT_WIDENING;
+            else if (value == "puct") spec.mcts.selection = SELECT_PUCT;
+            else return false;
+        } else if (key == "c") {
+            spec.mcts.explorationConstant = static_cast<float>(number);
+        } else if (key == "puct") {
+            spec.mcts.puctConstant = static_cast<float>(number);
+        } else if (key == "temp") {
+            spec.mcts.priorTemperature = static_cast<float>(number);
+        } else if (key == "rollout") {
+            spec.mcts.rolloutDepth = static_cast<int>(number);
+        } else if (key == "batch") {
+            spec.mcts.rolloutBatch = static_cast<int>(number);
+        } else if (key == "widen") {
+            spec.mcts.wideningBase = static_cast<float>(number);
+        } else if (key == "tt") {
+            spec.mcts.transpositionTableMB = static_cast<int>(number);
+        } else if (key == "tree") {
+            spec.mcts.treeMemoryMB = static_cast<int>(number);
+        } else if (key == "depth") {
+            spec.alphaBeta.maxDepth = static_cast<int>(number);
+        } else if (key == "hash") {
+            spec.alphaBeta.hashMB = static_cast<int>(number);
+        } else if (key == "book") {
+            std::shared_ptr<OpeningBook> book = std::make_shared<OpeningBook>();
+            if (!book->open(value)) {
+                std::fprintf(stderr, "cannot open opening book %s\n", value.c_str());
+                return false;
+            }
+            spec.book = book;
+        } else {
+            std::fprintf(stderr, "unknown option '%s'\n", key.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<SearchEngine> CreatePlayer(const PlayerSpec& spec) {
+    std::unique_ptr<SearchEngine> engine;
+    if (spec.engine == ENGINE_ALPHABETA) {
+        std::unique_ptr<AlphaBeta> ab(new AlphaBeta);
+        ab->config = spec.alphaBeta;
+        engine.reset(ab.release());
+    } else {
+        std::unique_ptr<MCTS> mcts(new MCTS);
+        mcts->config = spec.mcts;
+        engine.reset(mcts.release());
+    }
+    engine->SetOpeningBook(spec.book);
+    return engine;
+}
+
+struct GameRecord {
+    int index = 0;
+    bool aIsBlack = true;
+    bool aWins = false;
+    std::vector<AmazonMove> moves; // 含随机开局
+    int openingPlies = 0;
+};
+
+// 第 pair 对开局：用固定种子随机走 plies 步，同一对的两盘开局相同
+std::vector<AmazonMove> RandomOpening(uint32_t seed, int pair, int plies) {
+    std::mt19937 rng(seed + static_cast<uint32_t>(pair) * 7919u);
+    AmazonBoard board;
+    int player = BLACK_QUEEN;
+    std::vector<AmazonMove> moves;
+    for (int i = 0; i < plies; i++) {
+        AmazonMove m;
+        if (!SampleRandomMove(board, player, rng, m)) break;
+        board.MakeMove(m, player);
+        moves.push_back(m);
+        player = 3 - player;
+    }
+    return moves;
+}
+
+GameRecord PlayGame(int index, const PlayerSpec& a, const PlayerSpec& b, const std::vector<AmazonMove>& opening) {
+    GameRecord record;
+    record.index = index;
+    record.aIsBlack = (index % 2 == 0);
+    record.openingPlies = static_cast<int>(opening.size());
+    // engines[1] 执白，engines[2] 执黑
+    std::unique_ptr<SearchEngine> engines[3];
+    engines[BLACK_QUEEN] = CreatePlayer(record.aIsBlack ? a : b);
+    engines[WHITE_QUEEN] = CreatePlayer(record.aIsBlack ? b : a);
+    const SearchLimits* limits[3] = {nullptr, record.aIsBlack ? &b.limits : &a.limits, record.aIsBlack ? &a.limits : &b.limits};
+
+    AmazonBoard board;
+    int player = BLACK_QUEEN; // 黑方先走
+    for (const AmazonMove& m : opening) {
+        board.MakeMove(m, player);
+        record.moves.push_back(m);
+        player = 3 - player;
+    }
+    while (HasAnyMove(board, player)) {
+        AmazonMove m = engines[player]->GetBestMove(board, player, *limits[player]);
+        board.MakeMove(m, player);
+        engines[BLACK_QUEEN]->AdvanceRoot(m);
+        engines[WHITE_QUEEN]->AdvanceRoot(m);
+        record.moves.push_back(m);
+        player = 3 - player;
+    }
+    // 轮到谁走而无路可走，谁就输
+    bool blackWins = (player == WHITE_QUEEN);
+    record.aWins = (blackWins == record.aIsBlack);
+    return record;
+}
+
+// 写进 JSON 字符串里的文本：转义引号、反斜杠和控制字符
+std::string JsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+void WriteGame(FILE* f, const GameRecord& g, const PlayerSpec& a, const PlayerSpec& b) {
+    std::string black = JsonEscape(g.aIsBlack ? a.text : b.text);
+    std::string white = JsonEscape(g.aIsBlack ? b.text : a.text);
+    std::fprintf(f, "{\"game\": %d, \"black\": \"%s\", \"white\": \"%s\", \"winner\": \"%s\", \"opening_plies\": %d, \"moves\": [",
+                 g.index, black.c_str(), white.c_str(), (g.aWins == g.aIsBlack) ? "black" : "white", g.openingPlies);
+    for (size_t i = 0; i < g.moves.size(); i++) {
+        const AmazonMove& m = g.moves[i];
+        std::fprintf(f, "%s\"%d %d %d %d %d %d\"", i ? ", " : "", m.qx1, m.qy1, m.qx2, m.qy2, m.ax, m.ay);
+    }
+    std::fprintf(f, "]}\n");
+    std::fflush(f);
+}
+
+// 得分率 score 对应的 Elo 差
+double EloFromScore(double score) {
+    score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+double ScoreFromElo(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+// 亚马逊棋没有和棋，每盘是一次伯努利试验。H0：Elo 差为 elo0，H1：为 elo1
+double LogLikelihoodRatio(int wins, int losses, double elo0, double elo1) {
+    double p0 = ScoreFromElo(elo0);
+    double p1 = ScoreFromElo(elo1);
+    return wins * std::log(p1 / p0) + losses * std::log((1.0 - p1) / (1.0 - p0));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    PlayerSpec a, b;
+    bool haveA = false, haveB = false;
+    int games = 100;
+    int concurrency = std::max(1u, std::thread::hardware_concurrency());
+    int openingPlies = 2;
+    uint32_t seed = 1;
+    const char* outPath = "selfplay_games.jsonl";
+    const char* archivePath = nullptr;
+    bool sprt = false;
+    double elo0 = 0.0, elo1 = 10.0, alpha = 0.05, beta = 0.05;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--a" && hasValue) {
+            haveA = ParseSpec(argv[++i], a);
+            if (!haveA) return 1;
+        } else if (arg == "--b" && hasValue) {
+            haveB = ParseSpec(argv[++i], b);
+            if (!haveB) return 1;
+        } else if (arg == "--games" && hasValue) {
+            games = std::atoi(argv[++i]);
+        } else if (arg == "--concurrency" && hasValue) {
+            concurrency = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--opening-plies" && hasValue) {
+            openingPlies = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--out" && hasValue) {
+            outPath = argv[++i];
+        } else if (arg == "--archive" && hasValue) {
+            archivePath = argv[++i];
+        } else if (arg == "--sprt" && hasValue) {
+            // --sprt elo0,elo1
+            sprt = std::sscanf(argv[++i], "%lf,%lf", &elo0, &elo1) == 2;
+            if (!sprt) return 1;
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s --a SPEC --b SPEC [--games N] [--concurrency K] [--opening-plies P] [--seed S]\n"
+                         "          [--sprt elo0,elo1] [--out games.jsonl] [--archive games.amz]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    if (!haveA || !haveB) {
+        std::fprintf(stderr, "both --a and --b are required\n");
+        return 1;
+    }
+    FILE* out = std::fopen(outPath, "w");
+    if (!out) {
+        std::perror(outPath);
+        return 1;
+    }
+    GameArchiveWriter archive;
+    if (archivePath && !archive.open(archivePath)) {
+        std::fprintf(stderr, "cannot open game archive %s\n", archivePath);
+        return 1;
+    }
+
+    // SPRT 的判定界：LLR 低于 lower 接受 H0，高于 upper 接受 H1
+    const double lower = std::log(beta / (1.0 - alpha));
+    const double upper = std::log((1.0 - beta) / alpha);
+
+    // 开局两盘一对（2k 和 2k + 1），总盘数凑成偶数
+    games = (games + 1) & ~1;
+    std::mutex resultMutex;
+    // 下一盘的编号和盘数上限，都由 resultMutex 保护。SPRT 出结论后上限缩到已经开始的那一对的末尾，
+    // 配对不会被拆开，最终的得分和置信区间仍然是先后手平衡的
+    int nextGame = 0;
+    int gameLimit = games;
+    int wins = 0, losses = 0;
+    int sprtResult = 0; // 1 接受 H1，-1 接受 H0
+    double llr = 0.0;
+
+    auto worker = [&]() {
+        while (true) {
+            int index;
+            {
+                std::lock_guard<std::mutex> guard(resultMutex);
+                if (nextGame >= gameLimit) break;
+                index = nextGame++;
+            }
+            GameRecord g = PlayGame(index, a, b, RandomOpening(seed, index / 2, openingPlies));
+
+            std::lock_guard<std::mutex> guard(resultMutex);
+            (g.aWins ? wins : losses)++;
+            WriteGame(out, g, a, b);
+            if (archivePath) {
+                int winner = (g.aWins == g.aIsBlack) ? BLACK_QUEEN : WHITE_QUEEN;
+                archive.append(g.moves, winner, g.openingPlies);
+            }
+            int played = wins + losses;
+            std::fprintf(stderr, "game %d: %s wins (%d plies)  A %d - %d B  score %.3f\n", index, g.aWins ? "A" : "B",
+                         static_cast<int>(g.moves.size()), wins, losses, static_cast<double>(wins) / played);
+            if (sprt && sprtResult == 0) {
+                llr = LogLikelihoodRatio(wins, losses, elo0, elo1);
+                if (llr >= upper) sprtResult = 1;
+                if (llr <= lower) sprtResult = -1;
+                // 结论已出：不再开新的一对，正在下的局和已开始的那一对的另一盘下完也计入
+                if (sprtResult != 0) gameLimit = std::min(gameLimit, (nextGame + 1) & ~1);
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < std::min(concurrency, games); i++) {
+        threads.emplace_back(worker);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    std::fclose(out);
+    if (archivePath && !archive.close()) {
+        std::fprintf(stderr, "failed to write game archive %s\n", archivePath);
+    }
+
+    // 胜率的 95% 置信区间（正态近似）和对应的 Elo 区间
+    int played = wins + losses;
+    double score = played ? static_cast<double>(wins) / played : 0.5;
+    double margin = played ? 1.96 * std::sqrt(score * (1.0 - score) / played) : 0.5;
+    std::printf("{\n");
+    std::printf("  \"a\": \"%s\",\n  \"b\": \"%s\",\n", JsonEscape(a.text).c_str(), JsonEscape(b.text).c_str());
+    std::printf("  \"games\": %d,\n  \"a_wins\": %d,\n  \"b_wins\": %d,\n", played, wins, losses);
+    std::printf("  \"score\": %.4f,\n  \"score_ci95\": [%.4f, %.4f],\n", score, std::max(0.0, score - margin),
+                std::min(1.0, score + margin));
+    std::printf("  \"elo\": %.1f,\n  \"elo_ci95\": [%.1f, %.1f]", EloFromScore(score), EloFromScore(score - margin),
+                EloFromScore(score + margin));
+    if (sprt) {
+        llr = LogLikelihoodRatio(wins, losses, elo0, elo1);
+        std::printf(",\n  \"sprt\": {\"elo0\": %.1f, \"elo1\": %.1f, \"llr\": %.3f, \"bounds\": [%.3f, %.3f], \"result\": \"%s\"}",
+                    elo0, elo1, llr, lower, upper, sprtResult > 0 ? "H1" : sprtResult < 0 ? "H0" : "inconclusive");
+    }
+    std::printf(",\n  \"games_file\": \"%s\"\n}\n", JsonEscape(outPath).c_str());
+    return 0;
+}